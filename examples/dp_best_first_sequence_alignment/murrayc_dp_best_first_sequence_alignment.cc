@@ -0,0 +1,382 @@
+/* Copyright (C) 2016 Murray Cumming
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#include <boost/timer/timer.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <murraycdp/dp_best_first_stencil_base.h>
+#include <murraycdp/dp_bottom_up_stencil_base.h>
+#include <murraycdp/utils/stencil.h>
+
+class AlignmentCosts {
+public:
+  using type_value = unsigned int;
+
+  AlignmentCosts(type_value match_in, type_value mismatch_in, type_value gap_in)
+  : match(match_in), mismatch(mismatch_in), gap(gap_in) {}
+
+  AlignmentCosts(const AlignmentCosts& src) = default;
+  AlignmentCosts&
+  operator=(const AlignmentCosts& src) = default;
+
+  AlignmentCosts(AlignmentCosts&& src) noexcept = default;
+  AlignmentCosts&
+  operator=(AlignmentCosts&& src) noexcept = default;
+
+  type_value match;
+  type_value mismatch;
+  type_value gap;
+};
+
+/** Edit distance is an alignment in which a match costs 0,
+ * and a mismatch (a substitution) or a gap (an insertion or deletion)
+ * costs 1.
+ */
+static const AlignmentCosts EDIT_DISTANCE_COSTS(0, 1, 1);
+
+/** Prefer mismatches to gaps, but prefer matches to either,
+ * as in the dp_bottom_up_sequence_alignment example.
+ */
+static const AlignmentCosts SEQUENCE_ALIGNMENT_COSTS(1, 2, 3);
+
+/** Sub-problem (i, j) is the cheapest alignment of the first i characters of
+ * a with the first j characters of b. It uses (i - 1, j - 1), pairing a[i - 1]
+ * with b[j - 1], or (i - 1, j) or (i, j - 1), with a gap.
+ * Both DpBottomUpAlignment and DpBestFirstAlignment use this stencil.
+ */
+using AlignmentStencil =
+  murraycdp::utils::stencil<murraycdp::utils::offset<-1, -1>,
+    murraycdp::utils::offset<-1, 0>, murraycdp::utils::offset<0, -1>>;
+
+/** The cost that sub-problem (i, j) adds to the sub-problem at (i, j) +
+ * @a offsets.
+ */
+static AlignmentCosts::type_value
+get_alignment_edge_cost(const std::string& a, const std::string& b,
+  const AlignmentCosts& costs, const AlignmentStencil::type_offsets& offsets,
+  std::string::size_type i, std::string::size_type j) {
+  if (offsets[0] != 0 && offsets[1] != 0) {
+    return (a[i - 1] == b[j - 1]) ? costs.match : costs.mismatch;
+  }
+
+  return costs.gap;
+}
+
+/** Fill the whole table, keeping only 2 rows, to check DpBestFirstAlignment
+ * and to compare its speed.
+ */
+class DpBottomUpAlignment
+  : public murraycdp::DpBottomUpStencilBase<AlignmentStencil,
+      AlignmentCosts::type_value, std::string::size_type,
+      std::string::size_type> {
+public:
+  using type_value = AlignmentCosts::type_value;
+  using type_size = std::string::size_type;
+
+  DpBottomUpAlignment(
+    const std::string& a, const std::string& b, const AlignmentCosts& costs)
+  : DpBottomUpStencilBase(a.size() + 1, b.size() + 1),
+    a_(a),
+    b_(b),
+    costs_(costs) {}
+
+private:
+  type_subproblem
+  calc_subproblem(type_level level, type_size i, type_size j) const override {
+    if (i == 0 && j == 0) {
+      return 0;
+    }
+
+    auto result = std::numeric_limits<type_value>::max();
+    for (const auto& offsets : AlignmentStencil::get_offsets()) {
+      // The first row and column have only gaps:
+      if ((i == 0 && offsets[0] != 0) || (j == 0 && offsets[1] != 0)) {
+        continue;
+      }
+
+      const auto previous = get_subproblem(level,
+        static_cast<type_size>(static_cast<std::ptrdiff_t>(i) + offsets[0]),
+        static_cast<type_size>(static_cast<std::ptrdiff_t>(j) + offsets[1]));
+      result = std::min(result,
+        previous + get_alignment_edge_cost(a_, b_, costs_, offsets, i, j));
+    }
+
+    return result;
+  }
+
+  void
+  get_goal_cell(type_size& i, type_size& j) const override {
+    // The answer is in the last-calculated cell:
+    i = a_.size();
+    j = b_.size();
+  }
+
+  const std::string a_, b_;
+  const AlignmentCosts costs_;
+};
+
+/** This follows AlignmentStencil's dependencies forwards from (0, 0),
+ * towards the goal of (a.size(), b.size()).
+ */
+class DpBestFirstAlignment
+  : public murraycdp::DpBestFirstStencilBase<AlignmentStencil,
+      AlignmentCosts::type_value, std::string::size_type,
+      std::string::size_type> {
+public:
+  using type_value = AlignmentCosts::type_value;
+  using type_size = std::string::size_type;
+
+  DpBestFirstAlignment(
+    const std::string& a, const std::string& b, const AlignmentCosts& costs)
+  : a_(a),
+    b_(b),
+    costs_(costs),
+    min_pair_cost_(std::min(
+      {costs.match, costs.mismatch, static_cast<type_value>(costs.gap * 2)})) {}
+
+  static constexpr char GAP_CHAR = '-';
+
+  /** Get a and b, with gaps, aligned by the cheapest path found by calc().
+   */
+  std::pair<std::string, std::string>
+  get_solution() const {
+    std::string a, b;
+    const auto path = get_path();
+    for (std::size_t step = 1; step < path.size(); ++step) {
+      const auto i = std::get<0>(path[step]);
+      const auto j = std::get<1>(path[step]);
+      const auto i_previous = std::get<0>(path[step - 1]);
+      const auto j_previous = std::get<1>(path[step - 1]);
+      a += (i == i_previous) ? GAP_CHAR : a_[i - 1];
+      b += (j == j_previous) ? GAP_CHAR : b_[j - 1];
+    }
+
+    return std::make_pair(a, b);
+  }
+
+private:
+  void
+  get_start_cell(type_size& i, type_size& j) const override {
+    i = 0;
+    j = 0;
+  }
+
+  void
+  get_goal_cell(type_size& i, type_size& j) const override {
+    i = a_.size();
+    j = b_.size();
+  }
+
+  type_value
+  get_edge_cost(const type_offsets& offsets, type_size i,
+    type_size j) const override {
+    return get_alignment_edge_cost(a_, b_, costs_, offsets, i, j);
+  }
+
+  /** The remaining characters of the longer string that cannot be paired
+   * with characters of the other string need at least a gap each,
+   * and each remaining pair of characters costs at least a match, a
+   * mismatch, or two gaps.
+   */
+  type_value
+  get_heuristic(type_size i, type_size j) const override {
+    const auto a_remaining = a_.size() - i;
+    const auto b_remaining = b_.size() - j;
+    const auto pairs = std::min(a_remaining, b_remaining);
+    const auto unpaired = std::max(a_remaining, b_remaining) - pairs;
+    return unpaired * costs_.gap + pairs * min_pair_cost_;
+  }
+
+  const std::string a_, b_;
+  const AlignmentCosts costs_;
+  const type_value min_pair_cost_;
+};
+
+constexpr char DpBestFirstAlignment::GAP_CHAR;
+
+/** Get the cost of an alignment, such as one from get_solution().
+ */
+static AlignmentCosts::type_value
+calc_solution_cost(const std::pair<std::string, std::string>& solution,
+  const AlignmentCosts& costs) {
+  AlignmentCosts::type_value result = 0;
+  for (std::size_t i = 0; i < solution.first.size(); ++i) {
+    const auto char_a = solution.first[i];
+    const auto char_b = solution.second[i];
+    if (char_a == DpBestFirstAlignment::GAP_CHAR ||
+        char_b == DpBestFirstAlignment::GAP_CHAR) {
+      result += costs.gap;
+    } else {
+      result += (char_a == char_b) ? costs.match : costs.mismatch;
+    }
+  }
+
+  return result;
+}
+
+static std::string
+remove_gaps(const std::string& str) {
+  std::string result;
+  std::remove_copy(std::begin(str), std::end(str), std::back_inserter(result),
+    DpBestFirstAlignment::GAP_CHAR);
+  return result;
+}
+
+static void
+check_solution(const std::string& a, const std::string& b,
+  const AlignmentCosts& costs, const DpBestFirstAlignment& dp,
+  AlignmentCosts::type_value result) {
+  assert(dp.goal_is_reached());
+  DpBottomUpAlignment table(a, b, costs);
+  assert(result == table.calc());
+
+  const auto solution = dp.get_solution();
+  assert(solution.first.size() == solution.second.size());
+  assert(remove_gaps(solution.first) == a);
+  assert(remove_gaps(solution.second) == b);
+  assert(calc_solution_cost(solution, costs) == result);
+}
+
+/** Get a copy of @a str with about 1 character in @a rate replaced, removed, or
+ * followed by another character.
+ */
+static std::string
+mutate(const std::string& str, std::size_t rate, std::mt19937& generator) {
+  std::uniform_int_distribution<std::size_t> choice(0, rate * 3 - 1);
+  std::uniform_int_distribution<int> letter('A', 'D');
+  std::string result;
+  for (const auto ch : str) {
+    switch (choice(generator)) {
+      case 0:
+        result += static_cast<char>(letter(generator));
+        break;
+      case 1:
+        break;
+      case 2:
+        result += ch;
+        result += static_cast<char>(letter(generator));
+        break;
+      default:
+        result += ch;
+    }
+  }
+
+  return result;
+}
+
+static std::string
+get_random_string(std::size_t size, std::mt19937& generator) {
+  std::uniform_int_distribution<int> letter('A', 'D');
+  std::string result;
+  for (std::size_t i = 0; i < size; ++i) {
+    result += static_cast<char>(letter(generator));
+  }
+
+  return result;
+}
+
+int
+main() {
+  {
+    // As in the dp_bottom_up_string_edit_distance example:
+    const std::string str = "you should not";
+    const std::string pattern = "thou shalt not";
+
+    DpBestFirstAlignment dp(str, pattern, EDIT_DISTANCE_COSTS);
+    const auto result = dp.calc();
+    const auto solution = dp.get_solution();
+    std::cout << "edit distance: " << result << std::endl
+              << "  a: [" << solution.first << "]" << std::endl
+              << "  b: [" << solution.second << "]" << std::endl;
+
+    assert(result == 5);
+    check_solution(str, pattern, EDIT_DISTANCE_COSTS, dp, result);
+  }
+
+  {
+    // As in the dp_bottom_up_sequence_alignment example:
+    const std::string a = "GCCCTAGCG";
+    const std::string b = "GCGCAATG";
+
+    DpBestFirstAlignment dp(a, b, SEQUENCE_ALIGNMENT_COSTS);
+    const auto result = dp.calc();
+    const auto solution = dp.get_solution();
+    std::cout << "alignment cost: " << result << std::endl
+              << "  a: [" << solution.first << "]" << std::endl
+              << "  b: [" << solution.second << "]" << std::endl;
+
+    assert(result == 14);
+    check_solution(a, b, SEQUENCE_ALIGNMENT_COSTS, dp, result);
+  }
+
+  std::mt19937 generator(1);
+
+  // Compare with the whole table, for small unrelated strings,
+  // for which the heuristic helps least:
+  std::uniform_int_distribution<std::size_t> size_distribution(0, 12);
+  for (auto attempt = 0; attempt < 500; ++attempt) {
+    const auto a = get_random_string(size_distribution(generator), generator);
+    const auto b = get_random_string(size_distribution(generator), generator);
+    for (const auto& costs : {EDIT_DISTANCE_COSTS, SEQUENCE_ALIGNMENT_COSTS}) {
+      DpBestFirstAlignment dp(a, b, costs);
+      const auto result = dp.calc();
+      check_solution(a, b, costs, dp, result);
+    }
+  }
+
+  // For similar strings, only states near the diagonal should be expanded:
+  const auto a = get_random_string(5000, generator);
+  const auto b = mutate(a, 100, generator);
+  const auto table_size = (a.size() + 1) * (b.size() + 1);
+  for (const auto& costs : {EDIT_DISTANCE_COSTS, SEQUENCE_ALIGNMENT_COSTS}) {
+    AlignmentCosts::type_value table_result = 0;
+    DpBottomUpAlignment table(a, b, costs);
+    table.set_record_subproblem_accesses(false);
+    {
+      std::cout << "By filling the whole table, with DpBottomUpBase:"
+                << std::endl;
+      boost::timer::auto_cpu_timer timer;
+      table_result = table.calc();
+    }
+
+    AlignmentCosts::type_value result = 0;
+    DpBestFirstAlignment dp(a, b, costs);
+    {
+      std::cout << "By best-first search:" << std::endl;
+      boost::timer::auto_cpu_timer timer;
+      result = dp.calc();
+    }
+
+    std::cout << "cost: " << result << std::endl
+              << "table size: " << table_size << std::endl
+              << "expanded states: " << dp.count_expanded_states() << std::endl
+              << "reached states: " << dp.count_reached_states() << std::endl;
+    assert(result == table_result);
+    assert(dp.count_expanded_states() * 10 < table_size);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -24,12 +24,13 @@
 #include <vector>
 
 #include <murraycdp/dp_bottom_up_base.h>
+#include <murraycdp/utils/linear_recurrence.h>
 
 /** This is the simplest example of bottom-up dynamic programming,
- * just to see how much boilerplate is added by the use of DpBottomUpBase.
+ * just to see how much boilerplate is added by the use of DpBottomUp1DBase.
  * You'd be far better off just doing this:
  * @code
- * unsigned long calc_fibonacci(unsigned int n) {
+ * unsigned long calc_fibonacci_simply(unsigned int n) {
  *   if (n == 0)
  *     return 0;
  *   else if (n == 1)
@@ -47,19 +48,28 @@
  *   return result;
  * }
  * @endcode
+ *
+ * However, DpBottomUp1DBase keeps the 2 previous sub-problems in a
+ * std::array, and calls this class's calc_subproblem() directly, so the
+ * compiler can inline it into its loop. It calculates the first 2
+ * sub-problems in a separate loop, so the compiler can also remove the checks
+ * for the base cases from the main loop, which is then the same as this one.
  */
-class DpFibonacci
-  : public murraycdp::DpBottomUpBase<2, // count of subproblems to keep.
-      unsigned long,                    // sub problem type
-      unsigned int                      // i
+class DpFibonacci final
+  : public murraycdp::DpBottomUp1DBase<DpFibonacci,
+      2,             // count of subproblems to keep.
+      unsigned long, // sub problem type
+      unsigned int,  // i
+      false          // Don't keep a record of the sub-problem accesses.
       > {
 public:
   explicit DpFibonacci(unsigned int n)
-  : DpBottomUpBase(n + 1), // DpBottomUpBase without the specialization is
-    // apparently allowed.
-    n_(n) {}
+  : DpBottomUp1DBase(n + 1), n_(n) {}
 
 private:
+  // DpBottomUp1DBase calls calc_subproblem() and get_goal_cell() directly:
+  friend DpBottomUp1DBase;
+
   type_subproblem
   calc_subproblem(type_base::type_level level, unsigned int i) const override {
     // Base cases:
@@ -81,6 +91,27 @@ private:
   const unsigned int n_;
 };
 
+/** The simple loop from DpFibonacci's documentation.
+ */
+static unsigned long
+calc_fibonacci_simply(unsigned int n) {
+  if (n == 0)
+    return 0;
+  else if (n == 1)
+    return 1;
+
+  unsigned long result = 0;
+  unsigned long prev1 = 1; // f(1) = 0;
+  unsigned long prev2 = 0; // f(0) = 0;
+  for (unsigned int i = 1; i < n; ++i) {
+    result = (prev1 + prev2);
+    prev2 = prev1;
+    prev1 = result;
+  }
+
+  return result;
+}
+
 int
 main() {
   const auto n = 90;
@@ -98,5 +129,58 @@ main() {
 
   assert(result == 2880067194370816120ul);
 
+  // Past F(93), unsigned long overflows, so these are modulo 2^64,
+  // but that is enough to compare the speed of DpFibonacci with the simple
+  // loop:
+  {
+    const unsigned int big_n = 10000000;
+    std::cout << "fibonacci number " << big_n << " modulo 2^64, with DpFibonacci:"
+              << std::endl;
+    unsigned long dp_result = 0;
+    {
+      boost::timer::auto_cpu_timer timer;
+      DpFibonacci dp_big(big_n);
+      dp_result = dp_big.calc();
+    }
+
+    std::cout << "with the simple loop:" << std::endl;
+    unsigned long simple_result = 0;
+    {
+      boost::timer::auto_cpu_timer timer;
+      simple_result = calc_fibonacci_simply(big_n);
+    }
+
+    assert(dp_result == simple_result);
+  }
+
+  // Or, without calculating all the previous terms:
+  const murraycdp::utils::linear_recurrence<unsigned long long> fibonacci(
+    {1, 1}, {0, 1});
+  for (unsigned int i = 0; i <= n; ++i) {
+    DpFibonacci dp_i(i);
+    assert(fibonacci.calc(i) == dp_i.calc());
+  }
+
+  // Huge terms are only useful modulo something:
+  const unsigned long long modulus = 1000000007;
+  const murraycdp::utils::linear_recurrence<unsigned long long>
+    fibonacci_modulo({1, 1}, {0, 1}, modulus);
+  assert(fibonacci_modulo.calc(n) == result % modulus);
+
+  const auto huge_n = 1000000000000000000ull;
+  std::cout << "fibonacci number " << huge_n << " modulo " << modulus
+            << ", 100000 times:" << std::endl;
+  {
+    boost::timer::auto_cpu_timer timer;
+    unsigned long long huge_result = 0;
+    for (auto i = 0; i < 100000; ++i) {
+      huge_result = fibonacci_modulo.calc(huge_n - i);
+    }
+
+    assert(huge_result == fibonacci_modulo.calc(huge_n - 99999));
+  }
+
+  assert(fibonacci_modulo.calc(huge_n) == 209783453);
+
   return EXIT_SUCCESS;
 }
@@ -14,15 +14,22 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/
  */
 
+#include <boost/timer/timer.hpp>
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <map>
+#include <random>
 #include <string>
 #include <vector>
 
 #include <murraycdp/dp_bottom_up_base.h>
+#include <murraycdp/dp_bottom_up_row_base.h>
 
 class Item {
 public:
@@ -152,6 +159,1599 @@ private:
   const type_weight weight_capacity_;
 };
 
+/** A compact table of 1 bit per item per weight (or per value), remembering
+ * which choice each cell made, so a solution can be found afterwards, without
+ * storing a SubSolution, with its vector of items, in every cell.
+ */
+class DecisionBitmap {
+public:
+  using type_word = std::uint64_t;
+  using type_size = std::size_t;
+
+  static constexpr type_size BITS_PER_WORD = 64;
+
+  DecisionBitmap() : words_per_row_(0) {}
+
+  DecisionBitmap(type_size rows_count, type_size columns_count)
+  : words_per_row_((columns_count + BITS_PER_WORD - 1) / BITS_PER_WORD),
+    words_(rows_count * words_per_row_) {}
+
+  DecisionBitmap(const DecisionBitmap& src) = default;
+  DecisionBitmap&
+  operator=(const DecisionBitmap& src) = default;
+
+  DecisionBitmap(DecisionBitmap&& src) noexcept = default;
+  DecisionBitmap&
+  operator=(DecisionBitmap&& src) noexcept = default;
+
+  bool
+  empty() const {
+    return words_.empty();
+  }
+
+  bool
+  get(type_size row, type_size column) const {
+    return (words_[row * words_per_row_ + column / BITS_PER_WORD] >>
+             (column % BITS_PER_WORD)) &
+           1;
+  }
+
+  void
+  set(type_size row, type_size column) {
+    words_[row * words_per_row_ + column / BITS_PER_WORD] |=
+      type_word(1) << (column % BITS_PER_WORD);
+  }
+
+  /** The words of a row, to set many bits at once.
+   */
+  type_word*
+  get_row(type_size row) {
+    return &words_[row * words_per_row_];
+  }
+
+private:
+  type_size words_per_row_;
+  std::vector<type_word> words_;
+};
+
+constexpr DecisionBitmap::type_size DecisionBitmap::BITS_PER_WORD;
+
+/** Like DpKnapsack, but indexed by value instead of by weight, finding the
+ * least weight of a subset of the items whose value is at least each value,
+ * and then the greatest value whose least weight fits in the capacity.
+ *
+ * The table has (items + 1) * (total value + 1) cells instead of
+ * (items + 1) * (weight capacity + 1), so this is useful when the capacity is
+ * huge, such as 10^9 bytes, but the items' values are small.
+ * See KnapsackSolver, which chooses between them.
+ *
+ * Like DpKnapsackRows, this keeps only the previous item's row of weights,
+ * filling each row in one loop, and it remembers each cell's choice in a
+ * DecisionBitmap, to find the items afterwards, instead of keeping a vector
+ * of items in every cell.
+ */
+class DpKnapsackByValue final
+  : public murraycdp::DpBottomUpRowBase<2, // count of subproblems to keep.
+      Item::type_weight, SubSolution::type_vec_items::size_type,
+      Item::type_value> {
+public:
+  using type_value = Item::type_value;
+  using type_weight = Item::type_weight;
+  using type_vec_items = SubSolution::type_vec_items;
+  using type_size = type_vec_items::size_type;
+
+  /// The weight of a value that no subset of the items has.
+  static constexpr type_weight WEIGHT_INFINITY =
+    std::numeric_limits<type_weight>::max();
+
+  DpKnapsackByValue(const type_vec_items& items, type_weight weight_capacity)
+  : DpBottomUpRowBase(
+      items.size() + 1, calc_fitting_total_value(items, weight_capacity) + 1),
+    items_(items),
+    weight_capacity_(weight_capacity),
+    total_value_(calc_fitting_total_value(items, weight_capacity)) {}
+
+  /** Get the solution, as DpKnapsack::calc() would.
+   */
+  SubSolution
+  calc_solution() {
+    calc();
+
+    // The least weight for "at least this value" can only increase with the
+    // value, so we could use a binary search, but this is cheap compared to
+    // filling the table.
+    const auto& last_row = subproblems_.get_at_offset_from_start(items_.size());
+    auto value = total_value_;
+    while (value > 0 && last_row[value] > weight_capacity_) {
+      --value;
+    }
+
+    SubSolution result(0);
+    for (auto i = items_.size(); i > 0; --i) {
+      if (decisions_.get(i - 1, value)) {
+        const auto& item = items_[i - 1];
+        result.solution.emplace_back(item);
+        result.value += item.value;
+        value = std::max<type_value>(0, value - item.value);
+      }
+    }
+
+    std::reverse(std::begin(result.solution), std::end(result.solution));
+    return result;
+  }
+
+  static type_value
+  calc_total_value(const type_vec_items& items) {
+    type_value result = 0;
+    for (const auto& item : items) {
+      result += item.value;
+    }
+
+    return result;
+  }
+
+  /** The total value of the items that could fit on their own.
+   * No subset that fits can have more value than this.
+   */
+  static type_value
+  calc_fitting_total_value(
+    const type_vec_items& items, type_weight weight_capacity) {
+    type_value result = 0;
+    for (const auto& item : items) {
+      if (item.weight <= weight_capacity) {
+        result += item.value;
+      }
+    }
+
+    return result;
+  }
+
+private:
+  void
+  calc_row(type_size items_count, const type_previous_rows& previous_rows,
+    type_weight* row, type_value values_count) const override {
+    if (items_count == 0) {
+      // Any subset has at least 0 value, but no subset of 0 items has more:
+      row[0] = 0;
+      std::fill(row + 1, row + values_count, WEIGHT_INFINITY);
+      decisions_ = DecisionBitmap(items_.size(), values_count);
+      return;
+    }
+
+    const auto& item = items_[items_count - 1];
+    const type_weight* previous = previous_rows[0];
+
+    // Items that can never fit are not in the table's total value,
+    // so their values could be past the end of the row:
+    if (item.weight > weight_capacity_) {
+      std::copy(previous, previous + values_count, row);
+      return;
+    }
+
+    for (type_value value = 0; value < values_count; ++value) {
+      // If this item is in the lightest subset,
+      // the rest of the subset needs only the remaining value:
+      const auto rest = previous[std::max<type_value>(0, value - item.value)];
+      if (rest != WEIGHT_INFINITY && rest + item.weight < previous[value]) {
+        row[value] = rest + item.weight;
+        decisions_.set(items_count - 1, value);
+      } else {
+        row[value] = previous[value];
+      }
+    }
+  }
+
+  void
+  get_goal_cell(type_size& items_count, type_value& value) const override {
+    // calc_solution() looks at the whole last row,
+    // but this is the cell for the total value:
+    items_count = items_.size();
+    value = total_value_;
+  }
+
+  const type_vec_items items_;
+  const type_weight weight_capacity_;
+  const type_value total_value_;
+
+  // Whether item i is in the lightest subset for value v:
+  mutable DecisionBitmap decisions_;
+};
+
+constexpr DpKnapsackByValue::type_weight DpKnapsackByValue::WEIGHT_INFINITY;
+
+/** Like DpKnapsack, but only keeping the value, not the items, for each
+ * weight, in a single row that is updated in place for each item.
+ * The row is updated from the greatest weight down to the item's weight,
+ * so each cell still sees the previous item's values for lesser weights.
+ *
+ * This needs O(capacity) memory instead of O(capacity) SubSolutions, each
+ * with its own vector of items.
+ *
+ * Call calc() to get the best value. If @a keep_decisions was true, call
+ * get_solution() to get the items, which costs 1 bit per item per weight.
+ */
+class RollingKnapsack {
+public:
+  using type_value = Item::type_value;
+  using type_weight = Item::type_weight;
+  using type_vec_items = SubSolution::type_vec_items;
+  using type_size = type_vec_items::size_type;
+
+  RollingKnapsack(const type_vec_items& items, type_weight weight_capacity,
+    bool keep_decisions = false)
+  : items_(items),
+    weight_capacity_(weight_capacity),
+    keep_decisions_(keep_decisions) {}
+
+  type_value
+  calc() {
+    values_.assign(weight_capacity_ + 1, 0);
+    decisions_ = DecisionBitmap();
+    if (keep_decisions_) {
+      decisions_ = DecisionBitmap(items_.size(), weight_capacity_ + 1);
+    }
+
+    for (type_size i = 0; i < items_.size(); ++i) {
+      const auto& item = items_[i];
+      for (auto w = weight_capacity_; w >= item.weight; --w) {
+        const auto value_with_item = values_[w - item.weight] + item.value;
+        if (value_with_item > values_[w]) {
+          values_[w] = value_with_item;
+          if (keep_decisions_) {
+            decisions_.set(i, w);
+          }
+        }
+      }
+    }
+
+    return values_[weight_capacity_];
+  }
+
+  /** The best value for each weight capacity, up to the full capacity,
+   * as calculated by calc().
+   */
+  const std::vector<type_value>&
+  get_values() const {
+    return values_;
+  }
+
+  /** The items in the solution found by calc(),
+   * or an empty vector if the constructor's keep_decisions was false.
+   */
+  type_vec_items
+  get_solution() const {
+    type_vec_items result;
+    if (decisions_.empty()) {
+      return result;
+    }
+
+    auto w = weight_capacity_;
+    for (auto i = items_.size(); i > 0; --i) {
+      if (decisions_.get(i - 1, w)) {
+        const auto& item = items_[i - 1];
+        result.emplace_back(item);
+        w -= item.weight;
+      }
+    }
+
+    std::reverse(std::begin(result), std::end(result));
+    return result;
+  }
+
+private:
+  const type_vec_items items_;
+  const type_weight weight_capacity_;
+  const bool keep_decisions_;
+
+  std::vector<type_value> values_;
+
+  // Whether item i improved the value for weight w, when it was added:
+  DecisionBitmap decisions_;
+};
+
+/** Like DpKnapsackByValue, finding the least weight for each value, but in a
+ * single row that is updated in place for each item, as RollingKnapsack does
+ * for each weight. The row is updated from the greatest value down, so each
+ * cell still sees the previous item's weights for lesser values.
+ *
+ * This always remembers each cell's choice in a DecisionBitmap, so calc()
+ * can return the items.
+ */
+class RollingKnapsackByValue {
+public:
+  using type_value = Item::type_value;
+  using type_weight = Item::type_weight;
+  using type_vec_items = SubSolution::type_vec_items;
+  using type_size = type_vec_items::size_type;
+
+  RollingKnapsackByValue(
+    const type_vec_items& items, type_weight weight_capacity)
+  : items_(items),
+    weight_capacity_(weight_capacity),
+    total_value_(
+      DpKnapsackByValue::calc_fitting_total_value(items, weight_capacity)) {}
+
+  SubSolution
+  calc() {
+    const auto infinity = DpKnapsackByValue::WEIGHT_INFINITY;
+    weights_.assign(total_value_ + 1, infinity);
+    weights_[0] = 0; // Any subset has at least 0 value.
+    decisions_ = DecisionBitmap(items_.size(), total_value_ + 1);
+
+    for (type_size i = 0; i < items_.size(); ++i) {
+      const auto& item = items_[i];
+      if (item.weight > weight_capacity_) {
+        continue;
+      }
+
+      for (auto value = total_value_; value > 0; --value) {
+        const auto rest =
+          weights_[std::max<type_value>(0, value - item.value)];
+        if (rest != infinity && rest + item.weight < weights_[value]) {
+          weights_[value] = rest + item.weight;
+          decisions_.set(i, value);
+        }
+      }
+    }
+
+    auto value = total_value_;
+    while (value > 0 && weights_[value] > weight_capacity_) {
+      --value;
+    }
+
+    SubSolution result(0);
+    for (auto i = items_.size(); i > 0; --i) {
+      if (decisions_.get(i - 1, value)) {
+        const auto& item = items_[i - 1];
+        result.solution.emplace_back(item);
+        result.value += item.value;
+        value = std::max<type_value>(0, value - item.value);
+      }
+    }
+
+    std::reverse(std::begin(result.solution), std::end(result.solution));
+    return result;
+  }
+
+private:
+  const type_vec_items items_;
+  const type_weight weight_capacity_;
+  const type_value total_value_;
+
+  // The least weight of a subset with at least each value:
+  std::vector<type_weight> weights_;
+
+  // Whether item i reduced the weight for value v, when it was added:
+  DecisionBitmap decisions_;
+};
+
+/** Like RollingKnapsack, finding just the best value for each weight, but
+ * with DpBottomUpRowBase, which keeps the previous item's row, so each row can
+ * be filled in increasing order of weight, with a loop that has no branches,
+ * which the compiler can vectorize.
+ */
+class DpKnapsackRows final
+  : public murraycdp::DpBottomUpRowBase<2, // count of subproblems to keep.
+      Item::type_value, SubSolution::type_vec_items::size_type,
+      Item::type_weight> {
+public:
+  using type_value = Item::type_value;
+  using type_weight = Item::type_weight;
+  using type_vec_items = SubSolution::type_vec_items;
+  using type_size = type_vec_items::size_type;
+
+  DpKnapsackRows(const type_vec_items& items, type_weight weight_capacity)
+  : DpBottomUpRowBase(items.size() + 1, weight_capacity + 1),
+    items_(items),
+    weight_capacity_(weight_capacity) {}
+
+private:
+  void
+  calc_row(type_size items_count, const type_previous_rows& previous_rows,
+    type_value* row, type_weight weights_count) const override {
+    if (items_count == 0) {
+      std::fill(row, row + weights_count, 0);
+      return;
+    }
+
+    const auto& item = items_[items_count - 1];
+    const type_value* previous = previous_rows[0];
+
+    // The item cannot be in the solutions for lesser weights:
+    const auto item_weight = std::min(item.weight, weights_count);
+    std::copy(previous, previous + item_weight, row);
+
+    for (auto w = item_weight; w < weights_count; ++w) {
+      row[w] = std::max(previous[w], previous[w - item_weight] + item.value);
+    }
+  }
+
+  void
+  get_goal_cell(type_size& items_count, type_weight& weight) const override {
+    items_count = items_.size();
+    weight = weight_capacity_;
+  }
+
+  const type_vec_items items_;
+  const type_weight weight_capacity_;
+};
+
+/** Finds the greatest total weight, up to the capacity, of a subset of the
+ * items, ignoring their values.
+ * This keeps 1 bit per weight, for whether any subset has that weight, and
+ * adds each item by shifting those bits by its weight and ORing them in,
+ * a word at a time.
+ *
+ * Call calc() to get the best weight. If @a keep_decisions was true, call
+ * get_solution() to get the items, which costs 1 bit per item per weight.
+ */
+class BitsetSubsetSum {
+public:
+  using type_weight = Item::type_weight;
+  using type_vec_items = SubSolution::type_vec_items;
+  using type_size = type_vec_items::size_type;
+  using type_word = DecisionBitmap::type_word;
+
+  BitsetSubsetSum(const type_vec_items& items, type_weight weight_capacity,
+    bool keep_decisions = false)
+  : items_(items),
+    weight_capacity_(weight_capacity),
+    keep_decisions_(keep_decisions),
+    words_count_(
+      (weight_capacity + DecisionBitmap::BITS_PER_WORD) /
+      DecisionBitmap::BITS_PER_WORD) {}
+
+  type_weight
+  calc() {
+    reachable_.assign(words_count_, 0);
+    reachable_[0] = 1; // The empty subset.
+    decisions_ = DecisionBitmap();
+    if (keep_decisions_) {
+      decisions_ = DecisionBitmap(items_.size(), weight_capacity_ + 1);
+    }
+
+    const auto bits = DecisionBitmap::BITS_PER_WORD;
+    for (type_size i = 0; i < items_.size(); ++i) {
+      const auto weight = items_[i].weight;
+      if (weight > weight_capacity_) {
+        continue;
+      }
+
+      const type_size word_shift = weight / bits;
+      const type_size bit_shift = weight % bits;
+      type_word* decisions = keep_decisions_ ? decisions_.get_row(i) : nullptr;
+
+      // From the last word down, so we only read words that we have not yet
+      // changed for this item:
+      for (auto k = words_count_; k-- > word_shift;) {
+        type_word shifted = reachable_[k - word_shift] << bit_shift;
+        if (bit_shift && k > word_shift) {
+          shifted |= reachable_[k - word_shift - 1] >> (bits - bit_shift);
+        }
+
+        const auto added = shifted & ~reachable_[k];
+        reachable_[k] |= added;
+        if (decisions) {
+          decisions[k] = added;
+        }
+      }
+    }
+
+    // Ignore any bits beyond the capacity, in the last word:
+    const auto last_bits = (weight_capacity_ + 1) % bits;
+    if (last_bits) {
+      reachable_.back() &= (type_word(1) << last_bits) - 1;
+    }
+
+    for (auto k = words_count_; k-- > 0;) {
+      if (reachable_[k]) {
+        best_weight_ = k * bits + get_highest_bit_index(reachable_[k]);
+        return best_weight_;
+      }
+    }
+
+    best_weight_ = 0;
+    return best_weight_;
+  }
+
+  /** Whether any subset of the items has exactly this weight,
+   * as calculated by calc().
+   */
+  bool
+  is_reachable(type_weight weight) const {
+    const auto bits = DecisionBitmap::BITS_PER_WORD;
+    return (reachable_[weight / bits] >> (weight % bits)) & 1;
+  }
+
+  /** The items in the solution found by calc(),
+   * or an empty vector if the constructor's keep_decisions was false.
+   */
+  type_vec_items
+  get_solution() const {
+    type_vec_items result;
+    if (decisions_.empty()) {
+      return result;
+    }
+
+    // The decision bit is set for the item that first made the weight
+    // reachable, so the weight without that item was already reachable
+    // by earlier items:
+    auto w = best_weight_;
+    for (auto i = items_.size(); i > 0 && w > 0; --i) {
+      if (decisions_.get(i - 1, w)) {
+        const auto& item = items_[i - 1];
+        result.emplace_back(item);
+        w -= item.weight;
+      }
+    }
+
+    std::reverse(std::begin(result), std::end(result));
+    return result;
+  }
+
+private:
+  static type_size
+  get_highest_bit_index(type_word bits) {
+#if defined(__GNUC__)
+    return DecisionBitmap::BITS_PER_WORD - 1 - __builtin_clzll(bits);
+#else
+    type_size result = 0;
+    while (bits >>= 1) {
+      ++result;
+    }
+
+    return result;
+#endif
+  }
+
+  const type_vec_items items_;
+  const type_weight weight_capacity_;
+  const bool keep_decisions_;
+  const type_size words_count_;
+
+  // Bit w is set if some subset of the items has weight w:
+  std::vector<type_word> reachable_;
+
+  // Whether item i first made weight w reachable:
+  DecisionBitmap decisions_;
+  type_weight best_weight_ = 0;
+};
+
+/** Solves a 0/1 knapsack problem with few items, but with any weights,
+ * by listing the weights and values of every subset of each half of the
+ * items, and then finding the best pair of subsets, one from each half,
+ * that fits in the capacity.
+ *
+ * This takes O(2^(n/2)) time and memory, regardless of the capacity or
+ * the values, so it is useful when neither DpKnapsack nor DpKnapsackByValue
+ * could allocate its table.
+ */
+class MeetInTheMiddleKnapsack {
+public:
+  using type_value = Item::type_value;
+  using type_weight = Item::type_weight;
+  using type_vec_items = SubSolution::type_vec_items;
+  using type_size = type_vec_items::size_type;
+
+  /** Each half then has at most 23 items, needing 2^23 subsets.
+   */
+  static constexpr type_size MAX_ITEMS_COUNT = 45;
+
+  MeetInTheMiddleKnapsack(const type_vec_items& items, type_weight weight_capacity)
+  : items_(items), weight_capacity_(weight_capacity) {}
+
+  SubSolution
+  calc() const {
+    const auto items_count = items_.size();
+    assert(items_count <= MAX_ITEMS_COUNT);
+
+    const auto half = items_count / 2;
+    const auto first = get_subset_sums(0, half);
+    const auto second = get_subset_sums(half, items_count);
+
+    // Both lists are in order of increasing weight and increasing value,
+    // so, as the first half's subset gets heavier, the best subset from the
+    // second half that still fits can only get lighter:
+    type_value best_value = -1;
+    type_mask best_first = 0;
+    type_mask best_second = 0;
+    auto j = second.weights.size();
+    for (type_size i = 0; i < first.weights.size(); ++i) {
+      const auto remaining = weight_capacity_ - first.weights[i];
+      while (j > 0 && second.weights[j - 1] > remaining) {
+        --j;
+      }
+
+      if (j == 0) {
+        break;
+      }
+
+      const auto value = first.values[i] + second.values[j - 1];
+      if (value > best_value) {
+        best_value = value;
+        best_first = first.masks[i];
+        best_second = second.masks[j - 1];
+      }
+    }
+
+    SubSolution result(best_value);
+    add_items(result.solution, 0, best_first);
+    add_items(result.solution, half, best_second);
+    return result;
+  }
+
+private:
+  // A bit for each item in one half:
+  using type_mask = std::uint32_t;
+
+  /** The weights, values, and items of subsets,
+   * in separate arrays, so the loops over them are simple.
+   */
+  class SubsetSums {
+  public:
+    void
+    clear() {
+      weights.clear();
+      values.clear();
+      masks.clear();
+    }
+
+    void
+    add(type_weight weight, type_value value, type_mask mask) {
+      weights.emplace_back(weight);
+      values.emplace_back(value);
+      masks.emplace_back(mask);
+    }
+
+    std::vector<type_weight> weights;
+    std::vector<type_value> values;
+    std::vector<type_mask> masks;
+  };
+
+  /** Get the subsets of the items from @a begin to @a end that fit in the
+   * capacity, in order of increasing weight, without any subset that is
+   * dominated by another subset with no more weight but at least as much
+   * value. So the values increase too.
+   */
+  SubsetSums
+  get_subset_sums(type_size begin, type_size end) const {
+    SubsetSums result;
+    result.add(0, 0, 0);
+
+    SubsetSums merged;
+    for (auto k = begin; k < end; ++k) {
+      const auto& item = items_[k];
+      if (item.weight > weight_capacity_) {
+        continue;
+      }
+
+      const type_mask bit = type_mask(1) << (k - begin);
+
+      // Merge the subsets without this item with the same subsets with this
+      // item, which are already in order of weight too, keeping only the
+      // subsets with more value than any lighter subset. A dominated subset
+      // stays dominated when we add more items to both subsets.
+      merged.clear();
+      const auto count = result.weights.size();
+      const auto limit = weight_capacity_ - item.weight;
+      type_size a = 0;
+      type_size b = 0;
+      type_value best_value = -1;
+      while (a < count || (b < count && result.weights[b] <= limit)) {
+        type_weight weight = 0;
+        type_value value = 0;
+        type_mask mask = 0;
+        if (b >= count || result.weights[b] > limit ||
+            (a < count && result.weights[a] <= result.weights[b] + item.weight)) {
+          weight = result.weights[a];
+          value = result.values[a];
+          mask = result.masks[a];
+          ++a;
+        } else {
+          weight = result.weights[b] + item.weight;
+          value = result.values[b] + item.value;
+          mask = result.masks[b] | bit;
+          ++b;
+        }
+
+        if (value <= best_value) {
+          continue;
+        }
+
+        best_value = value;
+
+        // Replace a subset of the same weight, which has less value:
+        if (!merged.weights.empty() && merged.weights.back() == weight) {
+          merged.values.back() = value;
+          merged.masks.back() = mask;
+        } else {
+          merged.add(weight, value, mask);
+        }
+      }
+
+      std::swap(result, merged);
+    }
+
+    return result;
+  }
+
+  void
+  add_items(type_vec_items& solution, type_size begin, type_mask mask) const {
+    for (auto k = begin; mask; ++k, mask >>= 1) {
+      if (mask & 1) {
+        solution.emplace_back(items_[k]);
+      }
+    }
+  }
+
+  const type_vec_items items_;
+  const type_weight weight_capacity_;
+};
+
+constexpr MeetInTheMiddleKnapsack::type_size
+  MeetInTheMiddleKnapsack::MAX_ITEMS_COUNT;
+
+/** Finds a solution to a 0/1 knapsack problem whose value is at least
+ * (1 - epsilon) times the optimal value, by rounding each item's value down
+ * to a multiple of epsilon * (the greatest value) / (the count of items),
+ * and solving that smaller problem with RollingKnapsackByValue.
+ *
+ * The row of values then has O(n^2 / epsilon) cells, regardless of the
+ * values or the weight capacity, so this takes O(n^3 / epsilon) time.
+ * get_upper_bound() gives the most that the optimal value could be.
+ */
+class FptasKnapsack {
+public:
+  using type_value = Item::type_value;
+  using type_weight = Item::type_weight;
+  using type_vec_items = SubSolution::type_vec_items;
+  using type_size = type_vec_items::size_type;
+
+  FptasKnapsack(
+    const type_vec_items& items, type_weight weight_capacity, double epsilon)
+  : items_(items),
+    weight_capacity_(weight_capacity),
+    scale_(calc_scale(items, weight_capacity, epsilon)) {}
+
+  SubSolution
+  calc() {
+    // Items that cannot fit would only make the scale bigger:
+    type_vec_items scaled_items;
+    std::vector<type_size> original_indices;
+    for (type_size i = 0; i < items_.size(); ++i) {
+      const auto& item = items_[i];
+      if (item.weight <= weight_capacity_) {
+        scaled_items.emplace_back(scale_value(item.value, scale_), item.weight);
+        original_indices.emplace_back(i);
+      }
+    }
+
+    RollingKnapsackByValue knapsack(scaled_items, weight_capacity_);
+    const auto scaled_result = knapsack.calc();
+
+    // The solution's items are in the same order as scaled_items,
+    // so we can find their original items:
+    SubSolution result(0);
+    type_size k = 0;
+    for (const auto& item : scaled_result.solution) {
+      while (scaled_items[k].value != item.value ||
+             scaled_items[k].weight != item.weight) {
+        ++k;
+      }
+
+      const auto& original = items_[original_indices[k]];
+      result.solution.emplace_back(original);
+      result.value += original.value;
+      ++k;
+    }
+
+    // Rounding down loses less than the scale from each item's value,
+    // so the optimal solution has less than this much more value:
+    upper_bound_ = result.value;
+    if (scale_ > 1) {
+      upper_bound_ += static_cast<type_value>(
+        std::floor(scaled_items.size() * scale_));
+    }
+
+    return result;
+  }
+
+  /** No solution has more value than this, as calculated by calc().
+   */
+  type_value
+  get_upper_bound() const {
+    return upper_bound_;
+  }
+
+  /** The total value of the rounded-down items that can fit,
+   * for estimating the size of the value table.
+   */
+  static type_value
+  calc_scaled_total_value(
+    const type_vec_items& items, type_weight weight_capacity, double epsilon) {
+    const auto scale = calc_scale(items, weight_capacity, epsilon);
+    type_value result = 0;
+    for (const auto& item : items) {
+      if (item.weight <= weight_capacity) {
+        result += scale_value(item.value, scale);
+      }
+    }
+
+    return result;
+  }
+
+private:
+  static double
+  calc_scale(
+    const type_vec_items& items, type_weight weight_capacity, double epsilon) {
+    type_value max_value = 0;
+    type_size count = 0;
+    for (const auto& item : items) {
+      if (item.weight <= weight_capacity) {
+        max_value = std::max(max_value, item.value);
+        ++count;
+      }
+    }
+
+    if (epsilon <= 0 || count == 0) {
+      return 1;
+    }
+
+    // There is no point in scaling integer values up:
+    return std::max(1.0, epsilon * max_value / count);
+  }
+
+  static type_value
+  scale_value(type_value value, double scale) {
+    return static_cast<type_value>(std::floor(value / scale));
+  }
+
+  const type_vec_items items_;
+  const type_weight weight_capacity_;
+  const double scale_;
+  type_value upper_bound_ = 0;
+};
+
+/** Shrinks a 0/1 knapsack problem before it is solved, and translates the
+ * smaller problem's solution back to the original items:
+ *
+ * - Items that cannot fit, or that have no value, are removed.
+ * - Items with no weight are always taken, so they are removed too.
+ * - An item is removed if it is dominated (no lighter and no more valuable)
+ *   by other items that could not all fit with it.
+ *   Then any solution with the item would be at least as good with one of
+ *   the dominating items instead.
+ * - Identical items are merged into bundles of 1, 2, 4, ... items,
+ *   so m copies need only about log2(m) rows.
+ * - The weights and the capacity are divided by the weights' greatest common
+ *   divisor.
+ *
+ * get_table_size() can be compared with get_original_table_size() to see
+ * how much smaller a DpKnapsack table for the reduced problem would be.
+ */
+class KnapsackReduction {
+public:
+  using type_value = Item::type_value;
+  using type_weight = Item::type_weight;
+  using type_vec_items = SubSolution::type_vec_items;
+  using type_size = type_vec_items::size_type;
+
+  KnapsackReduction(const type_vec_items& items, type_weight weight_capacity)
+  : original_items_(items),
+    original_weight_capacity_(weight_capacity),
+    weight_capacity_(weight_capacity),
+    weight_divisor_(1) {
+    reduce();
+  }
+
+  KnapsackReduction(const KnapsackReduction& src) = default;
+  KnapsackReduction&
+  operator=(const KnapsackReduction& src) = default;
+
+  KnapsackReduction(KnapsackReduction&& src) noexcept = default;
+  KnapsackReduction&
+  operator=(KnapsackReduction&& src) noexcept = default;
+
+  /** The items of the reduced problem.
+   */
+  const type_vec_items&
+  get_items() const {
+    return items_;
+  }
+
+  /** The weight capacity of the reduced problem.
+   */
+  type_weight
+  get_weight_capacity() const {
+    return weight_capacity_;
+  }
+
+  /** The greatest common divisor of the weights,
+   * by which the reduced problem's weights have been divided.
+   */
+  type_weight
+  get_weight_divisor() const {
+    return weight_divisor_;
+  }
+
+  /** Get the solution of the original problem, from a solution of the
+   * reduced problem, whose items must be in the same order as in get_items(),
+   * as they are from DpKnapsack and KnapsackSolver.
+   */
+  SubSolution
+  translate(const SubSolution& reduced) const {
+    SubSolution result(0);
+    for (const auto i : always_taken_) {
+      result.solution.emplace_back(original_items_[i]);
+    }
+
+    type_size k = 0;
+    for (const auto& item : reduced.solution) {
+      while (items_[k].value != item.value || items_[k].weight != item.weight) {
+        ++k;
+      }
+
+      for (const auto i : original_indices_[k]) {
+        result.solution.emplace_back(original_items_[i]);
+      }
+
+      ++k;
+    }
+
+    for (const auto& item : result.solution) {
+      result.value += item.value;
+    }
+
+    return result;
+  }
+
+  /** The size of a DpKnapsack table for the original problem.
+   * This is a double because it can be too big for the integer types.
+   */
+  double
+  get_original_table_size() const {
+    return (original_items_.size() + 1.0) * (original_weight_capacity_ + 1.0);
+  }
+
+  /** The size of a DpKnapsack table for the reduced problem.
+   */
+  double
+  get_table_size() const {
+    return (items_.size() + 1.0) * (weight_capacity_ + 1.0);
+  }
+
+private:
+  void
+  reduce() {
+    std::vector<type_size> kept;
+    for (type_size i = 0; i < original_items_.size(); ++i) {
+      const auto& item = original_items_[i];
+      if (item.value <= 0 || item.weight > weight_capacity_) {
+        continue;
+      }
+
+      if (item.weight <= 0) {
+        always_taken_.emplace_back(i);
+      } else {
+        kept.emplace_back(i);
+      }
+    }
+
+    remove_dominated(kept);
+    add_bundles(kept);
+
+    // Any total weight is then a multiple of the divisor,
+    // so it fits if it fits in the capacity rounded down to a multiple:
+    type_weight divisor = 0;
+    for (const auto& item : items_) {
+      divisor = calc_gcd(divisor, item.weight);
+    }
+
+    if (divisor > 1) {
+      weight_divisor_ = divisor;
+      for (auto& item : items_) {
+        item.weight /= divisor;
+      }
+
+      weight_capacity_ /= divisor;
+    }
+  }
+
+  void
+  remove_dominated(std::vector<type_size>& kept) const {
+    // Try the least useful items first, so, of identical items,
+    // the later ones are removed.
+    auto candidates = kept;
+    std::stable_sort(std::begin(candidates), std::end(candidates),
+      [this](type_size a, type_size b) {
+        const auto& item_a = original_items_[a];
+        const auto& item_b = original_items_[b];
+        if (item_a.weight != item_b.weight) {
+          return item_a.weight > item_b.weight;
+        }
+
+        return item_a.value < item_b.value;
+      });
+
+    std::vector<bool> removed(original_items_.size());
+    for (auto a = candidates.rbegin(); a != candidates.rend(); ++a) {
+      const auto& item_a = original_items_[*a];
+
+      // The total weight of the other items that dominate this item:
+      type_weight dominating_weight = 0;
+      for (const auto b : kept) {
+        if (b == *a || removed[b]) {
+          continue;
+        }
+
+        const auto& item_b = original_items_[b];
+        if (item_b.weight <= item_a.weight && item_b.value >= item_a.value) {
+          dominating_weight += item_b.weight;
+          if (item_a.weight + dominating_weight > weight_capacity_) {
+            removed[*a] = true;
+            break;
+          }
+        }
+      }
+    }
+
+    kept.erase(std::remove_if(std::begin(kept), std::end(kept),
+                 [&removed](type_size i) { return removed[i]; }),
+      std::end(kept));
+  }
+
+  void
+  add_bundles(const std::vector<type_size>& kept) {
+    // Group the identical items, in order of their first occurrence:
+    std::vector<std::vector<type_size>> groups;
+    for (const auto i : kept) {
+      const auto& item = original_items_[i];
+      auto iter = std::find_if(std::begin(groups), std::end(groups),
+        [this, &item](const std::vector<type_size>& group) {
+          const auto& first = original_items_[group.front()];
+          return first.value == item.value && first.weight == item.weight;
+        });
+      if (iter == std::end(groups)) {
+        groups.emplace_back(1, i);
+      } else {
+        iter->emplace_back(i);
+      }
+    }
+
+    // Bundles of 1, 2, 4, ..., and the rest, can make any count of the
+    // items, up to all of them:
+    for (const auto& group : groups) {
+      const auto& item = original_items_[group.front()];
+      type_size used = 0;
+      for (type_size bundle_size = 1; used < group.size(); bundle_size *= 2) {
+        const auto size = std::min(bundle_size, group.size() - used);
+        items_.emplace_back(item.value * static_cast<type_value>(size),
+          item.weight * static_cast<type_weight>(size));
+        original_indices_.emplace_back(
+          group.begin() + used, group.begin() + used + size);
+        used += size;
+      }
+    }
+  }
+
+  static type_weight
+  calc_gcd(type_weight a, type_weight b) {
+    while (b != 0) {
+      const auto remainder = a % b;
+      a = b;
+      b = remainder;
+    }
+
+    return a;
+  }
+
+  type_vec_items original_items_;
+  type_weight original_weight_capacity_;
+
+  type_vec_items items_;
+  type_weight weight_capacity_;
+  type_weight weight_divisor_;
+
+  // The original items for each of the reduced problem's items:
+  std::vector<std::vector<type_size>> original_indices_;
+
+  // The original items that are in every solution:
+  std::vector<type_size> always_taken_;
+};
+
+/** Solves a 0/1 knapsack problem with DpKnapsack, DpKnapsackByValue, or
+ * MeetInTheMiddleKnapsack, whichever should need the least work.
+ * Or, if an @a epsilon was given to the constructor, perhaps with
+ * FptasKnapsack, if that would need less work.
+ *
+ * The problem is first shrunk by a KnapsackReduction.
+ */
+class KnapsackSolver {
+public:
+  using type_value = Item::type_value;
+  using type_weight = Item::type_weight;
+  using type_vec_items = SubSolution::type_vec_items;
+
+  enum class Method { BY_WEIGHT, BY_VALUE, MEET_IN_THE_MIDDLE, APPROXIMATE };
+
+  /**
+   * @param epsilon If more than 0, allow a solution whose value is at least
+   * (1 - epsilon) times the optimal value.
+   */
+  KnapsackSolver(const type_vec_items& items, type_weight weight_capacity,
+    double epsilon = 0)
+  : reduction_(items, weight_capacity),
+    items_(reduction_.get_items()),
+    weight_capacity_(reduction_.get_weight_capacity()),
+    epsilon_(epsilon),
+    method_(choose_method(items_, weight_capacity_, epsilon)) {}
+
+  SubSolution
+  calc() {
+    const auto reduced = calc_reduced();
+    const auto result = reduction_.translate(reduced);
+
+    // The items that the reduction always takes add the same value to any
+    // solution:
+    upper_bound_ += result.value - reduced.value;
+    return result;
+  }
+
+  /** No solution has more value than this, as calculated by calc().
+   * This is the value of calc()'s solution, unless get_method() is
+   * APPROXIMATE.
+   */
+  type_value
+  get_upper_bound() const {
+    return upper_bound_;
+  }
+
+  const KnapsackReduction&
+  get_reduction() const {
+    return reduction_;
+  }
+
+  Method
+  get_method() const {
+    return method_;
+  }
+
+  static std::string
+  get_method_as_string(Method method) {
+    switch (method) {
+      case Method::BY_WEIGHT:
+        return "by weight";
+      case Method::BY_VALUE:
+        return "by value";
+      case Method::MEET_IN_THE_MIDDLE:
+        return "meet in the middle";
+      case Method::APPROXIMATE:
+        return "approximate";
+      default:
+        return "unknown";
+    }
+  }
+
+private:
+  /** Solve the reduced problem.
+   */
+  SubSolution
+  calc_reduced() {
+    SubSolution result;
+    switch (method_) {
+      case Method::BY_VALUE: {
+        DpKnapsackByValue dp(items_, weight_capacity_);
+        result = dp.calc_solution();
+        break;
+      }
+      case Method::MEET_IN_THE_MIDDLE: {
+        const MeetInTheMiddleKnapsack knapsack(items_, weight_capacity_);
+        result = knapsack.calc();
+        break;
+      }
+      case Method::APPROXIMATE: {
+        FptasKnapsack knapsack(items_, weight_capacity_, epsilon_);
+        result = knapsack.calc();
+        upper_bound_ = knapsack.get_upper_bound();
+        return result;
+      }
+      case Method::BY_WEIGHT:
+      default: {
+        DpKnapsack dp(items_, weight_capacity_);
+        result = dp.calc();
+        break;
+      }
+    }
+
+    upper_bound_ = result.value;
+    return result;
+  }
+
+  static Method
+  choose_method(
+    const type_vec_items& items, type_weight weight_capacity, double epsilon) {
+    // The rough cost of each cell, or subset, relative to a cell of
+    // RollingKnapsackByValue's row, as measured with GCC at -O2.
+    // DpKnapsack copies a vector of items into each cell, so its cells cost
+    // more with more items.
+    const double cost_per_cell_by_weight = 4.0 * (items.size() + 1);
+    const double cost_per_cell_by_value = 1.5;
+    const double cost_per_subset_mitm = 1;
+    const double cost_per_cell_approximate = 1;
+
+    // The tables have a row per item.
+    // Items that could never fit add nothing to the value dimension.
+    // We use doubles, because these can be too big for the integer types.
+    double total_value = 0;
+    for (const auto& item : items) {
+      if (item.weight <= weight_capacity) {
+        total_value += item.value;
+      }
+    }
+
+    const double rows_count = items.size();
+    const double cost_by_weight =
+      rows_count * (weight_capacity + 1.0) * cost_per_cell_by_weight;
+    const double cost_by_value =
+      rows_count * (total_value + 1.0) * cost_per_cell_by_value;
+
+    // Each half's subsets are merged once per item, but the merges double in
+    // size, so this is roughly 2 * 2^(n/2) for each half.
+    const auto mitm_possible =
+      items.size() <= MeetInTheMiddleKnapsack::MAX_ITEMS_COUNT;
+    const double cost_mitm =
+      4 * std::ldexp(1.0, static_cast<int>((items.size() + 1) / 2)) *
+      cost_per_subset_mitm;
+
+    auto least_exact = std::min(cost_by_weight, cost_by_value);
+    if (mitm_possible) {
+      least_exact = std::min(least_exact, cost_mitm);
+    }
+
+    if (epsilon > 0) {
+      const double cost_approximate =
+        rows_count * (FptasKnapsack::calc_scaled_total_value(
+                        items, weight_capacity, epsilon) +
+                       1.0) *
+        cost_per_cell_approximate;
+      if (cost_approximate < least_exact) {
+        return Method::APPROXIMATE;
+      }
+    }
+
+    if (mitm_possible && cost_mitm == least_exact) {
+      return Method::MEET_IN_THE_MIDDLE;
+    }
+
+    return (cost_by_value < cost_by_weight) ? Method::BY_VALUE
+                                            : Method::BY_WEIGHT;
+  }
+
+  const KnapsackReduction reduction_;
+  const type_vec_items items_;
+  const type_weight weight_capacity_;
+  const double epsilon_;
+  const Method method_;
+  type_value upper_bound_ = 0;
+};
+
+/** An item that uses two resources, such as weight and volume.
+ * Or, the volume could be some other cost, such as a risk, with no capacity,
+ * to find the trade-offs between value and that cost.
+ */
+class ResourceItem {
+public:
+  using type_value = Item::type_value;
+  using type_weight = Item::type_weight;
+
+  ResourceItem() : value(0), weight(0), volume(0) {}
+
+  ResourceItem(
+    type_value value_in, type_weight weight_in, type_weight volume_in)
+  : value(value_in), weight(weight_in), volume(volume_in) {}
+
+  ResourceItem(const ResourceItem& src) = default;
+  ResourceItem&
+  operator=(const ResourceItem& src) = default;
+
+  ResourceItem(ResourceItem&& src) noexcept = default;
+  ResourceItem&
+  operator=(ResourceItem&& src) noexcept = default;
+
+  type_value value;
+  type_weight weight;
+  type_weight volume;
+};
+
+/** A 0/1 knapsack problem with both a weight capacity and a volume capacity.
+ *
+ * Instead of a (items + 1) * (weight capacity + 1) * (volume capacity + 1)
+ * table, this keeps, for each count of items, only the subsets that are not
+ * dominated by another subset with no more weight, no more volume, and at
+ * least as much value. These labels are kept in a flat array, in order of
+ * weight and then volume, so each item's front can be made by merging the
+ * previous front with a copy of it that includes the item.
+ *
+ * The dominance check then only needs to look at the labels already merged,
+ * which are no heavier. Of those, it keeps a staircase of the best value for
+ * each volume, so each check takes O(log(front size)), and each merge takes
+ * O(front size * log(front size)). The volumes still take part in the
+ * dominance check even with CAPACITY_UNLIMITED for the volume, so the
+ * staircase can grow with the front. Only when every item's volume is 0 does
+ * the staircase have just one step, making each check O(1).
+ *
+ * get_front_sizes() reports the size of each front, to compare with the
+ * size of the dense table.
+ */
+class ParetoKnapsack {
+public:
+  using type_value = ResourceItem::type_value;
+  using type_weight = ResourceItem::type_weight;
+  using type_vec_items = std::vector<ResourceItem>;
+  using type_size = type_vec_items::size_type;
+
+  static constexpr type_weight CAPACITY_UNLIMITED =
+    std::numeric_limits<type_weight>::max();
+
+  class Label {
+  public:
+    type_weight weight;
+    type_weight volume;
+    type_value value;
+
+    // The label in the previous front that this label was made from:
+    type_size previous;
+
+    // Whether this label's subset includes this front's item:
+    bool taken;
+  };
+
+  using type_front = std::vector<Label>;
+
+  ParetoKnapsack(const type_vec_items& items, type_weight weight_capacity,
+    type_weight volume_capacity = CAPACITY_UNLIMITED)
+  : items_(items),
+    weight_capacity_(weight_capacity),
+    volume_capacity_(volume_capacity) {}
+
+  /** Calculate the fronts, and return the best value.
+   */
+  type_value
+  calc() {
+    fronts_.clear();
+    fronts_.reserve(items_.size() + 1);
+    fronts_.emplace_back(type_front{Label{0, 0, 0, 0, false}});
+
+    for (const auto& item : items_) {
+      fronts_.emplace_back(calc_next_front(fronts_.back(), item));
+    }
+
+    const auto& front = fronts_.back();
+    best_ = 0;
+    for (type_size i = 1; i < front.size(); ++i) {
+      if (front[i].value > front[best_].value) {
+        best_ = i;
+      }
+    }
+
+    return front[best_].value;
+  }
+
+  /** The items in the solution found by calc().
+   */
+  type_vec_items
+  get_solution() const {
+    return get_solution(best_);
+  }
+
+  /** The items in the subset of one label of the final front.
+   */
+  type_vec_items
+  get_solution(type_size label_index) const {
+    type_vec_items result;
+    auto index = label_index;
+    for (auto i = items_.size(); i > 0; --i) {
+      const auto& label = fronts_[i][index];
+      if (label.taken) {
+        result.emplace_back(items_[i - 1]);
+      }
+
+      index = label.previous;
+    }
+
+    std::reverse(std::begin(result), std::end(result));
+    return result;
+  }
+
+  /** The final front: every subset that is not dominated, in order of
+   * weight and then volume.
+   */
+  const type_front&
+  get_front() const {
+    return fronts_.back();
+  }
+
+  /** The count of labels in the front for each count of items, from 0 items.
+   */
+  std::vector<type_size>
+  get_front_sizes() const {
+    std::vector<type_size> result;
+    for (const auto& front : fronts_) {
+      result.emplace_back(front.size());
+    }
+
+    return result;
+  }
+
+private:
+  type_front
+  calc_next_front(const type_front& previous, const ResourceItem& item) const {
+    type_front result;
+    result.reserve(previous.size() * 2);
+
+    // The best value for each volume, among the labels that we have already
+    // kept. The values increase with the volumes.
+    std::map<type_weight, type_value> staircase;
+
+    const auto count = previous.size();
+    type_size a = 0;
+    type_size b = 0;
+    while (a < count || b < count) {
+      // The next label with the item, skipping those that don't fit:
+      while (b < count && !fits(previous[b], item)) {
+        ++b;
+      }
+
+      Label label;
+      if (b >= count ||
+          (a < count && !is_before(with_item(previous[b], b, item), previous[a]))) {
+        if (a >= count) {
+          break;
+        }
+
+        label = previous[a];
+        label.previous = a;
+        label.taken = false;
+        ++a;
+      } else {
+        label = with_item(previous[b], b, item);
+        ++b;
+      }
+
+      // Is there a label that is no heavier (because it was merged first),
+      // no bigger, and at least as valuable?
+      auto iter = staircase.upper_bound(label.volume);
+      if (iter != staircase.begin() && std::prev(iter)->second >= label.value) {
+        continue;
+      }
+
+      // Remove the steps that this label dominates:
+      iter = staircase.lower_bound(label.volume);
+      while (iter != staircase.end() && iter->second <= label.value) {
+        iter = staircase.erase(iter);
+      }
+
+      staircase.emplace_hint(iter, label.volume, label.value);
+      result.emplace_back(label);
+    }
+
+    return result;
+  }
+
+  bool
+  fits(const Label& label, const ResourceItem& item) const {
+    return item.weight <= weight_capacity_ - label.weight &&
+           item.volume <= volume_capacity_ - label.volume;
+  }
+
+  static Label
+  with_item(const Label& label, type_size index, const ResourceItem& item) {
+    return Label{label.weight + item.weight, label.volume + item.volume,
+      label.value + item.value, index, true};
+  }
+
+  /** The merge order: by weight, then by volume, then by decreasing value.
+   */
+  static bool
+  is_before(const Label& a, const Label& b) {
+    if (a.weight != b.weight) {
+      return a.weight < b.weight;
+    }
+
+    if (a.volume != b.volume) {
+      return a.volume < b.volume;
+    }
+
+    return a.value > b.value;
+  }
+
+  const type_vec_items items_;
+  const type_weight weight_capacity_;
+  const type_weight volume_capacity_;
+
+  std::vector<type_front> fronts_;
+  type_size best_ = 0;
+};
+
+constexpr ParetoKnapsack::type_weight ParetoKnapsack::CAPACITY_UNLIMITED;
+
+/** The best value for a ParetoKnapsack problem, from a dense table of the
+ * best value for each weight and volume, updated in place for each item.
+ */
+static ResourceItem::type_value
+calc_resource_knapsack_by_table(const std::vector<ResourceItem>& items,
+  ResourceItem::type_weight weight_capacity,
+  ResourceItem::type_weight volume_capacity) {
+  const auto columns = volume_capacity + 1;
+  std::vector<ResourceItem::type_value> values(
+    (weight_capacity + 1) * columns, 0);
+  for (const auto& item : items) {
+    for (auto w = weight_capacity; w >= item.weight; --w) {
+      for (auto v = volume_capacity; v >= item.volume; --v) {
+        const auto with_item =
+          values[(w - item.weight) * columns + v - item.volume] + item.value;
+        auto& cell = values[w * columns + v];
+        cell = std::max(cell, with_item);
+      }
+    }
+  }
+
+  return values.back();
+}
+
+static std::vector<ResourceItem>
+get_random_resource_items(std::size_t count, ResourceItem::type_weight max_size,
+  ResourceItem::type_value max_value, std::mt19937& generator) {
+  std::uniform_int_distribution<ResourceItem::type_weight> size_distribution(
+    1, max_size);
+  std::uniform_int_distribution<ResourceItem::type_value> value_distribution(
+    1, max_value);
+  std::vector<ResourceItem> result;
+  for (std::size_t i = 0; i < count; ++i) {
+    const auto weight = size_distribution(generator);
+    const auto volume = size_distribution(generator);
+    result.emplace_back(value_distribution(generator), weight, volume);
+  }
+
+  return result;
+}
+
+static Item::type_value
+calc_items_value(const std::vector<Item>& items) {
+  Item::type_value result = 0;
+  for (const auto& item : items) {
+    result += item.value;
+  }
+
+  return result;
+}
+
+static Item::type_weight
+calc_items_weight(const std::vector<Item>& items) {
+  Item::type_weight result = 0;
+  for (const auto& item : items) {
+    result += item.weight;
+  }
+
+  return result;
+}
+
+static std::vector<Item>
+get_random_items(std::size_t count, Item::type_weight max_weight,
+  Item::type_value max_value, std::mt19937& generator) {
+  std::uniform_int_distribution<Item::type_weight> weight_distribution(
+    1, max_weight);
+  std::uniform_int_distribution<Item::type_value> value_distribution(
+    1, max_value);
+  std::vector<Item> result;
+  for (std::size_t i = 0; i < count; ++i) {
+    const auto weight = weight_distribution(generator);
+    result.emplace_back(value_distribution(generator), weight);
+  }
+
+  return result;
+}
+
 void
 print_vec(const std::vector<Item>& vec) {
   for (auto item : vec) {
@@ -184,5 +1784,459 @@ main() {
 
   assert(result.value == 84);
 
+  {
+    RollingKnapsack rolling(items, weight_capacity, true);
+    assert(rolling.calc() == 84);
+    const auto solution = rolling.get_solution();
+    assert(calc_items_value(solution) == 84);
+    assert(calc_items_weight(solution) <= weight_capacity);
+
+    BitsetSubsetSum subset_sum(items, weight_capacity, true);
+    assert(subset_sum.calc() == weight_capacity);
+    assert(calc_items_weight(subset_sum.get_solution()) == weight_capacity);
+  }
+
+  // Compare with DpKnapsack, and with each other:
+  std::mt19937 generator(1);
+  std::uniform_int_distribution<std::size_t> count_distribution(0, 20);
+  std::uniform_int_distribution<Item::type_weight> capacity_distribution(
+    0, 200);
+  for (auto attempt = 0; attempt < 300; ++attempt) {
+    const auto random_items =
+      get_random_items(count_distribution(generator), 60, 100, generator);
+    const auto capacity = capacity_distribution(generator);
+
+    DpKnapsack random_dp(random_items, capacity);
+    const auto expected = random_dp.calc().value;
+
+    RollingKnapsack rolling(random_items, capacity, true);
+    assert(rolling.calc() == expected);
+    const auto solution = rolling.get_solution();
+    assert(calc_items_value(solution) == expected);
+    assert(calc_items_weight(solution) <= capacity);
+
+    DpKnapsackRows rows(random_items, capacity);
+    assert(rows.calc() == expected);
+
+    // Subset sum is knapsack with each item's value equal to its weight:
+    auto weight_items = random_items;
+    for (auto& item : weight_items) {
+      item.value = item.weight;
+    }
+
+    DpKnapsack weight_dp(weight_items, capacity);
+    const auto expected_weight = weight_dp.calc().value;
+
+    BitsetSubsetSum subset_sum(random_items, capacity, true);
+    assert(subset_sum.calc() == expected_weight);
+    assert(calc_items_weight(subset_sum.get_solution()) == expected_weight);
+    for (Item::type_weight w = 0; w <= capacity; ++w) {
+      RollingKnapsack exact(weight_items, w);
+      assert(subset_sum.is_reachable(w) == (exact.calc() == w));
+    }
+  }
+
+  // Compare DpKnapsackByValue with DpKnapsack:
+  for (auto attempt = 0; attempt < 300; ++attempt) {
+    const auto random_items =
+      get_random_items(count_distribution(generator), 60, 20, generator);
+    const auto capacity = capacity_distribution(generator);
+
+    DpKnapsack random_dp(random_items, capacity);
+    const auto expected = random_dp.calc().value;
+
+    DpKnapsackByValue by_value(random_items, capacity);
+    const auto by_value_result = by_value.calc_solution();
+    assert(by_value_result.value == expected);
+    assert(calc_items_value(by_value_result.solution) == expected);
+    assert(calc_items_weight(by_value_result.solution) <= capacity);
+  }
+
+  {
+    // A capacity that is too big for a table indexed by weight:
+    const auto big_items = get_random_items(60, 100000000, 100, generator);
+    const Item::type_weight big_capacity = 1000000000;
+
+    KnapsackSolver solver(big_items, big_capacity);
+    assert(solver.get_method() == KnapsackSolver::Method::BY_VALUE);
+    std::cout << "KnapsackSolver, with " << big_items.size()
+              << " items and weight capacity " << big_capacity << ", "
+              << KnapsackSolver::get_method_as_string(solver.get_method())
+              << ":" << std::endl;
+    SubSolution big_result;
+    {
+      boost::timer::auto_cpu_timer timer;
+      big_result = solver.calc();
+    }
+
+    std::cout << "value: " << big_result.value << std::endl;
+    assert(calc_items_value(big_result.solution) == big_result.value);
+    assert(calc_items_weight(big_result.solution) <= big_capacity);
+
+    KnapsackSolver small_solver(items, weight_capacity);
+    assert(small_solver.calc().value == 84);
+
+    // An item too heavy to ever fit, with a value too big for a table,
+    // which KnapsackSolver does not count when choosing the method:
+    const SubSolution::type_vec_items heavy_items = {
+      {5, 3}, {7, 4}, {3, 2}, {20000000000, 5000000}};
+    const Item::type_weight heavy_capacity = 1000;
+    DpKnapsackByValue heavy_dp(heavy_items, heavy_capacity);
+    assert(heavy_dp.calc_solution().value == 15);
+    RollingKnapsack heavy_rolling(heavy_items, heavy_capacity);
+    assert(heavy_rolling.calc() == 15);
+    KnapsackSolver heavy_solver(heavy_items, heavy_capacity);
+    assert(heavy_solver.calc().value == 15);
+
+    // The same problem, with huge weights:
+    const Item::type_weight scale = 10000000;
+    auto scaled_items = items;
+    for (auto& item : scaled_items) {
+      item.weight *= scale;
+    }
+
+    DpKnapsackByValue scaled_dp(scaled_items, weight_capacity * scale);
+    assert(scaled_dp.calc_solution().value == 84);
+
+    // KnapsackReduction divides the weights by their common divisor,
+    // so this is as small as the original problem:
+    KnapsackSolver scaled_solver(scaled_items, weight_capacity * scale);
+    assert(scaled_solver.get_reduction().get_weight_divisor() == scale);
+    assert(scaled_solver.get_reduction().get_table_size() ==
+           small_solver.get_reduction().get_table_size());
+    assert(scaled_solver.get_method() == small_solver.get_method());
+    assert(scaled_solver.calc().value == 84);
+  }
+
+  // Compare MeetInTheMiddleKnapsack with DpKnapsack:
+  for (auto attempt = 0; attempt < 300; ++attempt) {
+    const auto random_items =
+      get_random_items(count_distribution(generator), 60, 100, generator);
+    const auto capacity = capacity_distribution(generator);
+
+    DpKnapsack random_dp(random_items, capacity);
+    const auto expected = random_dp.calc().value;
+
+    const MeetInTheMiddleKnapsack mitm(random_items, capacity);
+    const auto mitm_result = mitm.calc();
+    assert(mitm_result.value == expected);
+    assert(calc_items_value(mitm_result.solution) == expected);
+    assert(calc_items_weight(mitm_result.solution) <= capacity);
+  }
+
+  {
+    // Huge weights and values, for which neither table could be allocated:
+    const auto big_items = get_random_items(
+      40, 1000000000000LL, 1000000000000LL, generator);
+    const auto big_capacity = calc_items_weight(big_items) / 2;
+
+    KnapsackSolver solver(big_items, big_capacity);
+    assert(solver.get_method() == KnapsackSolver::Method::MEET_IN_THE_MIDDLE);
+    std::cout << "KnapsackSolver, with " << big_items.size()
+              << " items and weight capacity " << big_capacity << ", "
+              << KnapsackSolver::get_method_as_string(solver.get_method())
+              << ":" << std::endl;
+    SubSolution big_result;
+    {
+      boost::timer::auto_cpu_timer timer;
+      big_result = solver.calc();
+    }
+
+    std::cout << "value: " << big_result.value << std::endl;
+    assert(calc_items_value(big_result.solution) == big_result.value);
+    assert(calc_items_weight(big_result.solution) <= big_capacity);
+
+    // The same solver, with fewer items, compared with a brute-force search:
+    const std::vector<Item> few_items(big_items.begin(), big_items.begin() + 16);
+    const auto few_capacity = calc_items_weight(few_items) / 3;
+    Item::type_value expected = 0;
+    for (std::uint32_t subset = 0; subset < (1u << few_items.size());
+         ++subset) {
+      Item::type_value value = 0;
+      Item::type_weight weight = 0;
+      for (std::size_t k = 0; k < few_items.size(); ++k) {
+        if (subset & (1u << k)) {
+          value += few_items[k].value;
+          weight += few_items[k].weight;
+        }
+      }
+
+      if (weight <= few_capacity) {
+        expected = std::max(expected, value);
+      }
+    }
+
+    KnapsackSolver few_solver(few_items, few_capacity);
+    assert(few_solver.get_method() == KnapsackSolver::Method::MEET_IN_THE_MIDDLE);
+    assert(few_solver.calc().value == expected);
+  }
+
+  // Compare FptasKnapsack with DpKnapsack:
+  for (auto attempt = 0; attempt < 300; ++attempt) {
+    const auto random_items =
+      get_random_items(count_distribution(generator), 60, 1000, generator);
+    const auto capacity = capacity_distribution(generator);
+
+    DpKnapsack random_dp(random_items, capacity);
+    const auto expected = random_dp.calc().value;
+
+    for (const auto epsilon : {0.05, 0.3, 0.9}) {
+      FptasKnapsack fptas(random_items, capacity, epsilon);
+      const auto fptas_result = fptas.calc();
+      assert(calc_items_value(fptas_result.solution) == fptas_result.value);
+      assert(calc_items_weight(fptas_result.solution) <= capacity);
+      assert(fptas_result.value <= expected);
+      assert(fptas_result.value >= (1 - epsilon) * expected);
+      assert(fptas.get_upper_bound() >= expected);
+    }
+  }
+
+  {
+    // Trading accuracy for speed, with a capacity and values that make the
+    // exact tables big:
+    const auto big_items = get_random_items(100, 20000, 1000000, generator);
+    const auto big_capacity = calc_items_weight(big_items) / 2;
+
+    std::cout << "RollingKnapsack, with " << big_items.size()
+              << " items and weight capacity " << big_capacity << ":"
+              << std::endl;
+    Item::type_value expected = 0;
+    boost::timer::cpu_times rolling_times;
+    {
+      boost::timer::auto_cpu_timer timer;
+      RollingKnapsack rolling(big_items, big_capacity);
+      expected = rolling.calc();
+      rolling_times = timer.elapsed();
+    }
+
+    std::cout << "value: " << expected << std::endl;
+
+    std::cout << "DpKnapsackRows:" << std::endl;
+    Item::type_value rows_result = 0;
+    {
+      boost::timer::auto_cpu_timer timer;
+      DpKnapsackRows rows(big_items, big_capacity);
+      rows_result = rows.calc();
+    }
+
+    assert(rows_result == expected);
+
+    for (const auto epsilon : {0.3, 0.6}) {
+      KnapsackSolver solver(big_items, big_capacity, epsilon);
+      assert(solver.get_method() == KnapsackSolver::Method::APPROXIMATE);
+      std::cout << "KnapsackSolver, with epsilon " << epsilon << ", "
+                << KnapsackSolver::get_method_as_string(solver.get_method())
+                << ":" << std::endl;
+      SubSolution approximate_result;
+      boost::timer::cpu_times approximate_times;
+      {
+        boost::timer::auto_cpu_timer timer;
+        approximate_result = solver.calc();
+        approximate_times = timer.elapsed();
+      }
+
+      std::cout << "value: " << approximate_result.value
+                << ", upper bound: " << solver.get_upper_bound()
+                << ", speed-up compared to RollingKnapsack: "
+                << static_cast<double>(rolling_times.wall) /
+                     std::max<boost::timer::nanosecond_type>(
+                       1, approximate_times.wall)
+                << std::endl;
+      assert(approximate_times.wall < rolling_times.wall);
+      assert(approximate_result.value >= (1 - epsilon) * expected);
+      assert(solver.get_upper_bound() >= expected);
+      assert(calc_items_weight(approximate_result.solution) <= big_capacity);
+    }
+  }
+
+  // Compare DpKnapsack with and without KnapsackReduction,
+  // with some duplicate items, zero-weight items, and common divisors:
+  for (auto attempt = 0; attempt < 300; ++attempt) {
+    auto random_items =
+      get_random_items(count_distribution(generator), 30, 30, generator);
+    const auto random_count = random_items.size();
+    for (std::size_t i = 0; i < random_count / 2; ++i) {
+      random_items.emplace_back(random_items[i]);
+    }
+
+    const Item::type_weight divisor = 1 + attempt % 4;
+    for (auto& item : random_items) {
+      item.weight *= divisor;
+    }
+
+    if (attempt % 10 == 0) {
+      random_items.emplace_back(5, 0);
+    }
+
+    const auto capacity = capacity_distribution(generator);
+
+    DpKnapsack random_dp(random_items, capacity);
+    const auto expected = random_dp.calc().value;
+
+    const KnapsackReduction reduction(random_items, capacity);
+    assert(reduction.get_table_size() <= reduction.get_original_table_size());
+    DpKnapsack reduced_dp(reduction.get_items(), reduction.get_weight_capacity());
+    const auto reduced_result = reduction.translate(reduced_dp.calc());
+    assert(reduced_result.value == expected);
+    assert(calc_items_value(reduced_result.solution) == expected);
+    assert(calc_items_weight(reduced_result.solution) <= capacity);
+  }
+
+  {
+    // Prices in cents, that are all whole dollars, and many identical items:
+    std::vector<Item> priced_items;
+    for (const auto& item : get_random_items(40, 500, 1000, generator)) {
+      for (auto copies = 0; copies < 5; ++copies) {
+        priced_items.emplace_back(item.value, item.weight * 100);
+      }
+    }
+
+    const Item::type_weight priced_capacity = 500000;
+    const KnapsackReduction reduction(priced_items, priced_capacity);
+    std::cout << "KnapsackReduction, with " << priced_items.size()
+              << " items and weight capacity " << priced_capacity << ":"
+              << std::endl
+              << "  items: " << reduction.get_items().size()
+              << ", weight capacity: " << reduction.get_weight_capacity()
+              << std::endl
+              << "  table size: " << reduction.get_original_table_size()
+              << " reduced to " << reduction.get_table_size() << " ("
+              << reduction.get_original_table_size() /
+                   reduction.get_table_size()
+              << " times smaller)" << std::endl;
+    assert(reduction.get_weight_divisor() == 100);
+    assert(reduction.get_table_size() * 100 <
+           reduction.get_original_table_size());
+
+    RollingKnapsack rolling(priced_items, priced_capacity);
+    const auto expected = rolling.calc();
+
+    KnapsackSolver solver(priced_items, priced_capacity);
+    SubSolution priced_result;
+    {
+      boost::timer::auto_cpu_timer timer;
+      priced_result = solver.calc();
+    }
+
+    assert(priced_result.value == expected);
+    assert(calc_items_value(priced_result.solution) == expected);
+    assert(calc_items_weight(priced_result.solution) <= priced_capacity);
+  }
+
+  {
+    const auto big_items = get_random_items(100, 1000, 1000, generator);
+    const Item::type_weight big_capacity = 5000;
+
+    std::cout << "DpKnapsack, with " << big_items.size()
+              << " items and weight capacity " << big_capacity << ":"
+              << std::endl;
+    SubSolution expected;
+    {
+      boost::timer::auto_cpu_timer timer;
+      DpKnapsack big_dp(big_items, big_capacity);
+      expected = big_dp.calc();
+    }
+
+    std::cout << "RollingKnapsack, with decisions:" << std::endl;
+    {
+      boost::timer::auto_cpu_timer timer;
+      RollingKnapsack rolling(big_items, big_capacity, true);
+      assert(rolling.calc() == expected.value);
+      assert(calc_items_value(rolling.get_solution()) == expected.value);
+    }
+
+    std::cout << "BitsetSubsetSum, with decisions:" << std::endl;
+    {
+      boost::timer::auto_cpu_timer timer;
+      BitsetSubsetSum subset_sum(big_items, big_capacity, true);
+      assert(subset_sum.calc() == big_capacity);
+    }
+  }
+
+  // Compare ParetoKnapsack with a dense table:
+  for (auto attempt = 0; attempt < 300; ++attempt) {
+    const auto resource_items = get_random_resource_items(
+      count_distribution(generator) / 2, 20, 50, generator);
+    std::uniform_int_distribution<ResourceItem::type_weight> small_capacity(
+      0, 60);
+    const auto resource_weight_capacity = small_capacity(generator);
+    const auto resource_volume_capacity = small_capacity(generator);
+
+    ParetoKnapsack pareto(
+      resource_items, resource_weight_capacity, resource_volume_capacity);
+    const auto pareto_result = pareto.calc();
+    assert(pareto_result ==
+           calc_resource_knapsack_by_table(resource_items,
+             resource_weight_capacity, resource_volume_capacity));
+
+    // Each label of the front is the weight, volume, and value of its subset:
+    const auto& front = pareto.get_front();
+    for (std::size_t i = 0; i < front.size(); ++i) {
+      const auto solution = pareto.get_solution(i);
+      ResourceItem total;
+      for (const auto& item : solution) {
+        total.value += item.value;
+        total.weight += item.weight;
+        total.volume += item.volume;
+      }
+
+      assert(total.value == front[i].value);
+      assert(total.weight == front[i].weight);
+      assert(total.volume == front[i].volume);
+      assert(total.weight <= resource_weight_capacity);
+      assert(total.volume <= resource_volume_capacity);
+
+      // And no label dominates another:
+      for (std::size_t j = 0; j < front.size(); ++j) {
+        assert(i == j || !(front[j].weight <= front[i].weight &&
+                            front[j].volume <= front[i].volume &&
+                            front[j].value >= front[i].value));
+      }
+    }
+  }
+
+  {
+    const auto resource_items =
+      get_random_resource_items(40, 100, 1000, generator);
+    const ResourceItem::type_weight resource_capacity = 1000;
+    ParetoKnapsack pareto(resource_items, resource_capacity, resource_capacity);
+    std::cout << "ParetoKnapsack, with " << resource_items.size()
+              << " items and weight and volume capacities "
+              << resource_capacity << ":" << std::endl;
+    ResourceItem::type_value pareto_result = 0;
+    {
+      boost::timer::auto_cpu_timer timer;
+      pareto_result = pareto.calc();
+    }
+
+    std::cout << "value: " << pareto_result << std::endl << "front sizes: ";
+    std::size_t labels_count = 0;
+    for (const auto size : pareto.get_front_sizes()) {
+      std::cout << size << ", ";
+      labels_count += size;
+    }
+
+    const auto dense_size = (resource_items.size() + 1.0) *
+                            (resource_capacity + 1.0) *
+                            (resource_capacity + 1.0);
+    std::cout << std::endl
+              << "labels: " << labels_count
+              << ", dense table size: " << dense_size << std::endl;
+    assert(labels_count * 10 < dense_size);
+
+    // Value against risk, with no capacity for the risk.
+    // The best value is then the same as without the risk:
+    ParetoKnapsack risk_pareto(resource_items, resource_capacity);
+    std::vector<Item> weight_items;
+    for (const auto& item : resource_items) {
+      weight_items.emplace_back(item.value, item.weight);
+    }
+
+    RollingKnapsack rolling(weight_items, resource_capacity);
+    assert(risk_pareto.calc() == rolling.calc());
+    std::cout << "value and risk trade-offs: "
+              << risk_pareto.get_front().size() << std::endl;
+  }
+
   return EXIT_SUCCESS;
 }
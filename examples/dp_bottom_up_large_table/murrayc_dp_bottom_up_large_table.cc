@@ -0,0 +1,140 @@
+/* Copyright (C) 2016 Murray Cumming
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#include <boost/timer/timer.hpp>
+#include <murraycdp/dp_bottom_up_base.h>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+/** The count of paths from the top-left cell of a grid to each cell, going
+ * only down or right:
+ *   x(i, j) = x(i - 1, j) + x(i, j - 1)
+ * For a grid of 3 columns, that is 1, i + 1, and (i + 1) * (i + 2) / 2.
+ *
+ * DpBottomUpBase only keeps 2 rows, and DpBase::get_subproblem() only keeps
+ * a record of the first DpBase::MAX_RECORDED_SUBPROBLEM_ACCESSES accesses,
+ * so the memory used does not depend on the count of rows.
+ */
+class DpGridPaths final
+  : public murraycdp::DpBottomUpBase<
+      2 /* count of subproblems to keep, used in calc_subproblem() */,
+      std::uint64_t, std::size_t, std::size_t> {
+public:
+  DpGridPaths(std::size_t rows_count, std::size_t columns_count)
+  : DpBottomUpBase(rows_count, columns_count),
+    rows_count_(rows_count),
+    columns_count_(columns_count) {}
+
+private:
+  type_subproblem
+  calc_subproblem(type_level level, std::size_t i,
+    std::size_t j) const override {
+    if (i == 0 || j == 0) {
+      return 1;
+    }
+
+    return get_subproblem(level, i - 1, j) + get_subproblem(level, i, j - 1);
+  }
+
+  void
+  get_goal_cell(std::size_t& i, std::size_t& j) const override {
+    i = rows_count_ - 1;
+    j = columns_count_ - 1;
+  }
+
+  const std::size_t rows_count_;
+  const std::size_t columns_count_;
+};
+
+/** The sum of the row indices so far, in a table of 1 column:
+ *   x(i, 0) = x(i - 1, 0) + i
+ * which is i * (i + 1) / 2.
+ *
+ * This is a stress test of tables with more than 2^32 rows, whose i values
+ * must not wrap around. Unlike DpGridPaths, the result depends on every i, so
+ * a truncated i would give the wrong result.
+ */
+class DpRowSums final
+  : public murraycdp::DpBottomUpBase<
+      2 /* count of subproblems to keep, used in calc_subproblem() */,
+      std::uint64_t, std::size_t, std::size_t> {
+public:
+  explicit DpRowSums(std::size_t rows_count)
+  : DpBottomUpBase(rows_count, 1), rows_count_(rows_count) {}
+
+private:
+  type_subproblem
+  calc_subproblem(type_level level, std::size_t i,
+    std::size_t /* j */) const override {
+    if (i == 0) {
+      return 0;
+    }
+
+    return get_subproblem(level, i - 1, 0) + i;
+  }
+
+  void
+  get_goal_cell(std::size_t& i, std::size_t& j) const override {
+    i = rows_count_ - 1;
+    j = 0;
+  }
+
+  const std::size_t rows_count_;
+};
+
+/**
+ * By default, this fills 3 * 10^9 rows, whose i values go past 2^31, so they
+ * would not fit in an int. That takes about 30 seconds.
+ * Pass a count of rows, such as 5000000000, to go past 2^32 too, or a smaller
+ * count for a quicker test.
+ */
+int
+main(int argc, char** argv) {
+  std::size_t rows_count = 3000000000;
+  if (argc > 1) {
+    rows_count = std::stoull(argv[1]);
+  }
+
+  {
+    DpGridPaths dp(4, 3);
+    assert(dp.calc() == 10);
+  }
+
+  {
+    DpRowSums dp(5);
+    assert(dp.calc() == 10);
+  }
+
+  std::cout << "Rolling fill of " << rows_count << " rows:" << std::endl;
+
+  std::uint64_t result = 0;
+  {
+    boost::timer::auto_cpu_timer timer;
+    DpRowSums dp(rows_count);
+    result = dp.calc();
+  }
+
+  // i * (i + 1) / 2, for the last i:
+  const std::uint64_t n = rows_count - 1;
+  const std::uint64_t expected =
+    (n % 2 == 0) ? (n / 2) * (n + 1) : n * ((n + 1) / 2);
+  assert(result == expected);
+
+  return EXIT_SUCCESS;
+}
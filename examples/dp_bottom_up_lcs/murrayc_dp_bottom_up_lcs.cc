@@ -22,7 +22,7 @@
 #include <string>
 #include <vector>
 
-#include <murraycdp/dp_bottom_up_base.h>
+#include <murraycdp/dp_bottom_up_stencil_base.h>
 
 class SubSolution {
 public:
@@ -50,16 +50,21 @@ public:
  *
  * This DP solution for LCS uses O(nm) time,
  * but uses a suffix tree instead uses O(n + m) time.
+ *
+ * Each sub-problem depends on the ones at (i - 1, j - 1), (i - 1, j), and
+ * (i, j - 1), so only 2 values of i need to be kept.
  */
 class DpLCS
-  : public murraycdp::DpBottomUpBase<2, // count of subproblems to keep.
+  : public murraycdp::DpBottomUpStencilBase<
+      murraycdp::utils::stencil<murraycdp::utils::offset<-1, -1>,
+        murraycdp::utils::offset<-1, 0>, murraycdp::utils::offset<0, -1>>,
       SubSolution, std::string::size_type, std::string::size_type> {
 public:
   using type_value = SubSolution::type_value;
   using type_size = std::string::size_type;
 
   DpLCS(const std::string& x, const std::string& y)
-  : DpBottomUpBase(x.size() + 1, y.size() + 1), x_(x), y_(y) {}
+  : DpBottomUpStencilBase(x.size() + 1, y.size() + 1), x_(x), y_(y) {}
 
 private:
   type_subproblem
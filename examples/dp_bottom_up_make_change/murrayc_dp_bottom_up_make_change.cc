@@ -0,0 +1,272 @@
+/* Copyright (C) 2016 Murray Cumming
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#include <boost/timer/timer.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+/** The least count of coins needed for every amount up to a maximum,
+ * with any number of each denomination, so that many amounts can then be
+ * queried cheaply.
+ *
+ * Unlike DpMakeChange, in the dp_top_down_make_change example, which uses
+ * each coin at most once, and calculates one amount per calc(), this fills a
+ * 1D table for all amounts at once:
+ *   count[a] = min over coins c of (count[a - c] + 1)
+ *
+ * It adds one coin at a time, in chunks of amounts as big as the coin, so
+ * each chunk only depends on earlier chunks. Then the loop over a chunk is a
+ * simple element-wise min-plus of two arrays, which the compiler can
+ * vectorize. For a coin of 1, the chunks have only 1 amount, so that coin is
+ * no quicker than in the simple loop.
+ *
+ * For each amount, it also keeps the last coin used, so get_coins() can list
+ * the coins in O(count of coins).
+ */
+class MakeChangeTable {
+public:
+  using type_amount = unsigned int;
+  using type_count = std::uint32_t;
+  using type_vec_coins = std::vector<type_amount>;
+
+  /** Half the maximum, so adding 1 cannot overflow,
+   * and is still more than any real count.
+   */
+  static constexpr type_count COIN_COUNT_INFINITY =
+    std::numeric_limits<type_count>::max() / 2;
+
+  MakeChangeTable(const type_vec_coins& coins, type_amount max_amount)
+  : coins_(coins), max_amount_(max_amount) {
+    std::sort(std::begin(coins_), std::end(coins_));
+    coins_.erase(std::unique(std::begin(coins_), std::end(coins_)),
+      std::end(coins_));
+    coins_.erase(std::remove(std::begin(coins_), std::end(coins_), 0),
+      std::end(coins_));
+  }
+
+  void
+  calc() {
+    counts_.assign(max_amount_ + 1, COIN_COUNT_INFINITY);
+    last_coins_.assign(max_amount_ + 1, 0);
+    counts_[0] = 0;
+
+    if (coins_.empty()) {
+      return;
+    }
+
+    // Adding one coin at a time, over all amounts, in increasing order,
+    // lets each amount use any number of that coin.
+    for (const auto coin : coins_) {
+      // The amounts in each chunk of this coin's size only read amounts in
+      // earlier chunks, so they don't overlap the amounts that we change:
+      for (type_amount chunk_start = coin; chunk_start <= max_amount_;
+           chunk_start += coin) {
+        const auto size =
+          std::min<type_amount>(coin, max_amount_ - chunk_start + 1);
+        const type_count* source = &counts_[chunk_start - coin];
+        type_count* target = &counts_[chunk_start];
+        type_amount* last_coins = &last_coins_[chunk_start];
+        for (type_amount i = 0; i < size; ++i) {
+          const type_count candidate = source[i] + 1;
+          const bool better = candidate < target[i];
+          target[i] = better ? candidate : target[i];
+          last_coins[i] = better ? coin : last_coins[i];
+        }
+      }
+    }
+  }
+
+  /** Whether the amount can be made from the coins.
+   */
+  bool
+  is_possible(type_amount amount) const {
+    return counts_[amount] != COIN_COUNT_INFINITY;
+  }
+
+  /** The least count of coins needed for the amount,
+   * or COIN_COUNT_INFINITY if it cannot be made.
+   */
+  type_count
+  get_coin_count(type_amount amount) const {
+    return counts_[amount];
+  }
+
+  /** The coins of one of the solutions with the least count of coins,
+   * or an empty vector if the amount cannot be made.
+   */
+  type_vec_coins
+  get_coins(type_amount amount) const {
+    type_vec_coins result;
+    if (!is_possible(amount)) {
+      return result;
+    }
+
+    while (amount > 0) {
+      const auto coin = last_coins_[amount];
+      result.emplace_back(coin);
+      amount -= coin;
+    }
+
+    return result;
+  }
+
+  type_amount
+  get_max_amount() const {
+    return max_amount_;
+  }
+
+private:
+  type_vec_coins coins_;
+  const type_amount max_amount_;
+
+  std::vector<type_count> counts_;
+
+  // The last coin used for each amount, or 0 if there is none:
+  type_vec_coins last_coins_;
+};
+
+constexpr MakeChangeTable::type_count MakeChangeTable::COIN_COUNT_INFINITY;
+
+/** Calculate the least count of coins for every amount up to max_amount,
+ * with the simple loop over the coins for each amount.
+ */
+static std::vector<MakeChangeTable::type_count>
+calc_coin_counts_simply(
+  const MakeChangeTable::type_vec_coins& coins, MakeChangeTable::type_amount max_amount) {
+  std::vector<MakeChangeTable::type_count> result(
+    max_amount + 1, MakeChangeTable::COIN_COUNT_INFINITY);
+  result[0] = 0;
+  for (MakeChangeTable::type_amount amount = 1; amount <= max_amount;
+       ++amount) {
+    for (const auto coin : coins) {
+      if (coin != 0 && coin <= amount) {
+        result[amount] = std::min(result[amount], result[amount - coin] + 1);
+      }
+    }
+  }
+
+  return result;
+}
+
+static void
+check_table(const MakeChangeTable& table,
+  const MakeChangeTable::type_vec_coins& coins) {
+  const auto expected = calc_coin_counts_simply(coins, table.get_max_amount());
+  for (MakeChangeTable::type_amount amount = 0;
+       amount <= table.get_max_amount(); ++amount) {
+    assert(table.get_coin_count(amount) == expected[amount]);
+
+    const auto solution = table.get_coins(amount);
+    if (table.is_possible(amount)) {
+      assert(solution.size() == table.get_coin_count(amount));
+
+      MakeChangeTable::type_amount total = 0;
+      for (const auto coin : solution) {
+        assert(std::find(std::begin(coins), std::end(coins), coin) !=
+               std::end(coins));
+        total += coin;
+      }
+
+      assert(total == amount);
+    } else {
+      assert(solution.empty());
+    }
+  }
+}
+
+int
+main() {
+  {
+    // A greedy algorithm would use 25 + 1 + 1 + 1 + 1 + 1 for 30,
+    // if there were no 10 coin, but 15 + 15 is better:
+    const MakeChangeTable::type_vec_coins coins{1, 15, 25};
+    MakeChangeTable table(coins, 100);
+    table.calc();
+    assert(table.get_coin_count(30) == 2);
+    assert(table.get_coins(30) == MakeChangeTable::type_vec_coins({15, 15}));
+    assert(table.get_coin_count(0) == 0);
+    check_table(table, coins);
+  }
+
+  {
+    // Some amounts cannot be made:
+    const MakeChangeTable::type_vec_coins coins{6, 10, 15};
+    MakeChangeTable table(coins, 200);
+    table.calc();
+    assert(!table.is_possible(1));
+    assert(!table.is_possible(29));
+    assert(table.get_coin_count(31) == 3); // 6 + 10 + 15
+    check_table(table, coins);
+  }
+
+  // Compare with the simple loop, for random coins:
+  std::mt19937 generator(1);
+  std::uniform_int_distribution<std::size_t> count_distribution(1, 6);
+  std::uniform_int_distribution<MakeChangeTable::type_amount> coin_distribution(
+    1, 40);
+  for (auto attempt = 0; attempt < 200; ++attempt) {
+    MakeChangeTable::type_vec_coins coins;
+    const auto count = count_distribution(generator);
+    for (std::size_t i = 0; i < count; ++i) {
+      coins.emplace_back(coin_distribution(generator));
+    }
+
+    MakeChangeTable table(coins, 500);
+    table.calc();
+    check_table(table, coins);
+  }
+
+  // Fill the table once, and then answer many queries:
+  for (const auto& coins : {MakeChangeTable::type_vec_coins{1, 2, 5, 10, 20,
+                              50, 100, 200},
+         MakeChangeTable::type_vec_coins{20, 50, 70, 100, 200, 500}}) {
+    const MakeChangeTable::type_amount max_amount = 1000000;
+
+    std::cout << "Simple loop, for all amounts up to " << max_amount << ":"
+              << std::endl;
+    std::vector<MakeChangeTable::type_count> expected;
+    {
+      boost::timer::auto_cpu_timer timer;
+      expected = calc_coin_counts_simply(coins, max_amount);
+    }
+
+    std::cout << "MakeChangeTable:" << std::endl;
+    MakeChangeTable table(coins, max_amount);
+    {
+      boost::timer::auto_cpu_timer timer;
+      table.calc();
+    }
+
+    std::uniform_int_distribution<MakeChangeTable::type_amount>
+      amount_distribution(0, max_amount);
+    std::cout << "10000 queries:" << std::endl;
+    boost::timer::auto_cpu_timer timer;
+    for (auto query = 0; query < 10000; ++query) {
+      const auto amount = amount_distribution(generator);
+      assert(table.get_coin_count(amount) == expected[amount]);
+      assert(table.get_coins(amount).size() ==
+             (table.is_possible(amount) ? expected[amount] : 0));
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
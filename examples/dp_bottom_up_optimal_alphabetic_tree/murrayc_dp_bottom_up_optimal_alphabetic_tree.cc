@@ -0,0 +1,686 @@
+/* Copyright (C) 2016 Murray Cumming
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#include <boost/timer/timer.hpp>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <murraycdp/dp_bottom_up_base.h>
+#include <murraycdp/utils/range_aggregate.h>
+
+using type_weight = unsigned long;
+using type_weights = std::vector<type_weight>;
+using type_size = type_weights::size_type;
+
+/**
+ * An alphabetic tree: A binary tree whose leaves are the items, in their
+ * original order, such as a prefix code, or a search tree whose keys are only
+ * in the leaves.
+ *
+ * nodes[0] to nodes[n-1] are the leaves, for the n items, in order.
+ * The other nodes are the internal nodes.
+ */
+class AlphabeticTree {
+public:
+  static constexpr type_size NO_NODE = std::numeric_limits<type_size>::max();
+
+  class Node {
+  public:
+    type_size left = NO_NODE;
+    type_size right = NO_NODE;
+  };
+
+  /// The sum of each item's weight multiplied by its depth.
+  type_weight cost = 0;
+  type_size root = NO_NODE;
+  std::vector<Node> nodes;
+};
+
+/** Get the depth of each leaf in the tree.
+ */
+static std::vector<type_size>
+get_leaf_depths(const AlphabeticTree& tree, type_size leaves_count) {
+  std::vector<type_size> result(leaves_count, 0);
+  if (tree.root == AlphabeticTree::NO_NODE) {
+    return result;
+  }
+
+  // Avoid recursion, because the tree could be very deep:
+  std::vector<std::pair<type_size, type_size>> stack;
+  stack.emplace_back(tree.root, 0);
+  while (!stack.empty()) {
+    const auto node_and_depth = stack.back();
+    stack.pop_back();
+
+    const auto id = node_and_depth.first;
+    const auto depth = node_and_depth.second;
+    if (id < leaves_count) {
+      result[id] = depth;
+      continue;
+    }
+
+    const auto& node = tree.nodes[id];
+    stack.emplace_back(node.left, depth + 1);
+    stack.emplace_back(node.right, depth + 1);
+  }
+
+  return result;
+}
+
+/** Build the alphabetic tree whose leaves have these depths, in order.
+ * This is only possible if the depths could come from a full binary tree,
+ * which is the case for the depths from the Garsia-Wachs combination phase.
+ */
+static AlphabeticTree
+build_tree_for_leaf_depths(const std::vector<type_size>& depths) {
+  AlphabeticTree result;
+  const auto n = depths.size();
+  result.nodes.resize(n);
+  if (n == 0) {
+    return result;
+  }
+
+  // Combine adjacent nodes at the same depth as soon as we see them:
+  std::vector<std::pair<type_size, type_size>> stack;
+  for (type_size i = 0; i < n; ++i) {
+    stack.emplace_back(i, depths[i]);
+
+    while (stack.size() >= 2 &&
+           stack.back().second == stack[stack.size() - 2].second) {
+      const auto right = stack.back();
+      stack.pop_back();
+      const auto left = stack.back();
+      stack.pop_back();
+
+      AlphabeticTree::Node node;
+      node.left = left.first;
+      node.right = right.first;
+      result.nodes.emplace_back(node);
+      stack.emplace_back(result.nodes.size() - 1, left.second - 1);
+    }
+  }
+
+  assert(stack.size() == 1);
+  assert(stack.back().second == 0);
+  result.root = stack.back().first;
+  return result;
+}
+
+class SubSolution {
+public:
+  SubSolution() : value(0), left_size(0) {}
+
+  explicit SubSolution(type_weight value_in, type_size left_size_in)
+  : value(value_in), left_size(left_size_in) {}
+
+  SubSolution(const SubSolution& src) = default;
+  SubSolution&
+  operator=(const SubSolution& src) = default;
+
+  SubSolution(SubSolution&& src) noexcept = default;
+  SubSolution&
+  operator=(SubSolution&& src) noexcept = default;
+
+  type_weight value;
+
+  /// The number of items in the left sub-tree.
+  type_size left_size;
+};
+
+/**
+ * Find the optimal alphabetic tree, by choosing the best split for the tree
+ * and its sub-trees.
+ *
+ * This is like DpOptimalBinarySearchTree, but the items are only in the
+ * leaves, so only the leaves' weights matter.
+ *
+ * This uses O(n^3) time, so it is only useful as a reference for
+ * GarsiaWachs.
+ */
+class DpOptimalAlphabeticTree
+  : public murraycdp::DpBottomUpBase<0, /* keep all subproblems */
+      SubSolution, type_size, type_size> {
+public:
+  explicit DpOptimalAlphabeticTree(const type_weights& weights)
+  : DpBottomUpBase(weights.size() + 1, weights.size()),
+    weights_(weights),
+    weight_sums_(weights_) {}
+
+  /** Get the tree, after calling calc().
+   */
+  AlphabeticTree
+  get_tree() const {
+    AlphabeticTree result;
+    const auto n = weights_.size();
+    result.nodes.resize(n);
+    if (n == 0) {
+      return result;
+    }
+
+    type_size s = 0;
+    type_size i = 0;
+    get_goal_cell(s, i);
+
+    type_level level = 0;
+    result.cost = get_subproblem(level, s, i).value;
+    result.root = add_nodes(result, s, i);
+    return result;
+  }
+
+private:
+  type_subproblem
+  calc_subproblem(type_level level, type_size s, type_size i) const override {
+    // Base cases:
+    if (s <= 1) {
+      return type_subproblem(0, 0);
+    }
+
+    const auto size = weights_.size();
+    if (i + s > size) {
+      return type_subproblem(0, 0);
+    }
+
+    // Try every split into a left and right sub-tree:
+    auto min = std::numeric_limits<type_weight>::max();
+    type_size left_size_for_min = 0;
+    for (type_size left_size = 1; left_size < s; ++left_size) {
+      const auto left = get_subproblem(level, left_size, i);
+      const auto right = get_subproblem(level, s - left_size, i + left_size);
+      const auto cost = left.value + right.value;
+      if (cost < min) {
+        min = cost;
+        left_size_for_min = left_size;
+      }
+    }
+
+    // Every leaf in this sub-tree is one level deeper than in the sub-trees:
+    return type_subproblem(min + weight_sums_.sum(i, i + s), left_size_for_min);
+  }
+
+  void
+  get_goal_cell(type_size& s, type_size& i) const override {
+    // The answer is in the last-calculated cell:
+    s = weights_.size();
+    i = 0;
+  }
+
+  type_size
+  add_nodes(AlphabeticTree& tree, type_size s, type_size i) const {
+    if (s == 1) {
+      return i;
+    }
+
+    type_level level = 0;
+    const auto left_size = get_subproblem(level, s, i).left_size;
+
+    AlphabeticTree::Node node;
+    node.left = add_nodes(tree, left_size, i);
+    node.right = add_nodes(tree, s - left_size, i + left_size);
+    tree.nodes.emplace_back(node);
+    return tree.nodes.size() - 1;
+  }
+
+  const type_weights weights_;
+  const murraycdp::utils::range_aggregate<type_weight> weight_sums_;
+};
+
+/**
+ * Find the optimal alphabetic tree with the Garsia-Wachs algorithm, in
+ * O(n log n) time.
+ *
+ * This first combines the weights into a (non-alphabetic) tree, always
+ * combining the left-most pair whose left weight is not greater than the
+ * weight to the right of the pair, and moving the combined weight to the left.
+ * The leaves' depths in that tree are the depths of the leaves in an optimal
+ * alphabetic tree, so we can then build that in linear time.
+ *
+ * The working sequence is kept in an implicit treap (a randomly-balanced tree,
+ * ordered by position) with the maximum weight of each sub-tree, so we can
+ * remove a pair, and find where to insert the combined weight, in O(log n)
+ * time, instead of shifting the items of an array.
+ *
+ * See Knuth's The Art of Computer Programming, Volume 3, section 6.2.2.
+ */
+class GarsiaWachs {
+public:
+  explicit GarsiaWachs(const type_weights& weights) : weights_(weights) {}
+
+  AlphabeticTree
+  calc() {
+    const auto n = weights_.size();
+
+    // The combination tree's nodes:
+    // 0 to n-1 are the leaves, and the combinations follow.
+    combinations_.clear();
+    combinations_.resize(n);
+    combinations_.reserve(n == 0 ? 0 : 2 * n - 1);
+    treap_.clear();
+    treap_.reserve(n + 1);
+    root_ = NO_ITEM;
+    cost_ = 0;
+
+    for (type_size i = 0; i < n; ++i) {
+      push_back(weights_[i], i);
+
+      // Combine whenever there is a pair whose left item is not greater than
+      // the item after the pair:
+      while (size() >= 3 && weight_at(size() - 3) <= weight_at(size() - 1)) {
+        combine(size() - 2);
+      }
+    }
+
+    while (size() > 1) {
+      combine(size() - 1);
+    }
+
+    const auto depths = get_combination_depths();
+    auto result = build_tree_for_leaf_depths(depths);
+    result.cost = cost_;
+    return result;
+  }
+
+private:
+  static constexpr std::uint32_t NO_ITEM =
+    std::numeric_limits<std::uint32_t>::max();
+
+  class Item {
+  public:
+    type_weight weight;
+    type_weight max_weight; // Of this item's treap sub-tree.
+    type_size combination_id;
+    std::uint32_t priority;
+    std::uint32_t left;
+    std::uint32_t right;
+    std::uint32_t size; // Of this item's treap sub-tree.
+  };
+
+  /** Combine the items at @a k - 1 and @a k,
+   * and then any earlier pairs that that makes combinable.
+   */
+  void
+  combine(type_size k) {
+    // The positions, as distances from the end, of combinations whose
+    // earlier pairs still need to be checked. This avoids recursion, which
+    // could be very deep.
+    pending_.clear();
+    const auto pos = combine_pair(k);
+    pending_.emplace_back(size() - pos);
+
+    while (!pending_.empty()) {
+      const auto j = size() - pending_.back();
+      if (j >= 2 && weight_at(j) >= weight_at(j - 2)) {
+        const auto pos_earlier = combine_pair(j - 1);
+        pending_.emplace_back(size() - pos_earlier);
+      } else {
+        pending_.pop_back();
+      }
+    }
+  }
+
+  /** Combine the items at @a k - 1 and @a k,
+   * and move the combination to the left of all items that are less than it.
+   *
+   * @result The new position of the combination.
+   */
+  type_size
+  combine_pair(type_size k) {
+    assert(k >= 1);
+
+    // Split into the items before the pair, the pair, and the items after it:
+    std::uint32_t before = NO_ITEM;
+    std::uint32_t pair = NO_ITEM;
+    std::uint32_t after = NO_ITEM;
+    split(root_, k - 1, before, pair);
+    split(pair, 2, pair, after);
+
+    // The pair is a root with one child:
+    auto left = pair;
+    auto right = pair;
+    if (treap_[pair].left != NO_ITEM) {
+      left = treap_[pair].left;
+    } else {
+      right = treap_[pair].right;
+    }
+
+    const auto weight = treap_[left].weight + treap_[right].weight;
+    cost_ += weight;
+
+    AlphabeticTree::Node node;
+    node.left = treap_[left].combination_id;
+    node.right = treap_[right].combination_id;
+    combinations_.emplace_back(node);
+    const auto combination_id = combinations_.size() - 1;
+
+    free_items_.emplace_back(left);
+    free_items_.emplace_back(right);
+
+    // Insert after the right-most item, before the pair, that is not less
+    // than the combination:
+    type_size j = 0;
+    if (find_last_at_least(before, 0, k - 1, weight, j)) {
+      ++j;
+    }
+
+    std::uint32_t a = NO_ITEM;
+    std::uint32_t b = NO_ITEM;
+    split(before, j, a, b);
+    root_ =
+      merge(merge(a, new_item(weight, combination_id)), merge(b, after));
+    return j;
+  }
+
+  std::vector<type_size>
+  get_combination_depths() const {
+    const auto n = weights_.size();
+    AlphabeticTree tree;
+    tree.nodes = combinations_;
+    tree.root = (root_ == NO_ITEM) ? AlphabeticTree::NO_NODE
+                                   : treap_[root_].combination_id;
+    return get_leaf_depths(tree, n);
+  }
+
+  // The implicit treap:
+
+  type_size
+  size() const {
+    return size_of(root_);
+  }
+
+  type_size
+  size_of(std::uint32_t id) const {
+    return id == NO_ITEM ? 0 : treap_[id].size;
+  }
+
+  type_weight
+  max_weight_of(std::uint32_t id) const {
+    return id == NO_ITEM ? 0 : treap_[id].max_weight;
+  }
+
+  void
+  update(std::uint32_t id) {
+    auto& item = treap_[id];
+    item.size = 1 + size_of(item.left) + size_of(item.right);
+    item.max_weight = std::max(
+      item.weight, std::max(max_weight_of(item.left), max_weight_of(item.right)));
+  }
+
+  std::uint32_t
+  merge(std::uint32_t a, std::uint32_t b) {
+    if (a == NO_ITEM) {
+      return b;
+    } else if (b == NO_ITEM) {
+      return a;
+    }
+
+    if (treap_[a].priority > treap_[b].priority) {
+      treap_[a].right = merge(treap_[a].right, b);
+      update(a);
+      return a;
+    } else {
+      treap_[b].left = merge(a, treap_[b].left);
+      update(b);
+      return b;
+    }
+  }
+
+  /** Split into the first @a count items, and the rest.
+   */
+  void
+  split(std::uint32_t id, type_size count, std::uint32_t& a, std::uint32_t& b) {
+    if (id == NO_ITEM) {
+      a = b = NO_ITEM;
+      return;
+    }
+
+    auto& item = treap_[id];
+    const auto left_size = size_of(item.left);
+    if (count <= left_size) {
+      split(item.left, count, a, treap_[id].left);
+      b = id;
+    } else {
+      split(item.right, count - left_size - 1, treap_[id].right, b);
+      a = id;
+    }
+
+    update(id);
+  }
+
+  std::uint32_t
+  new_item(type_weight weight, type_size combination_id) {
+    // Reuse the storage of erased items:
+    std::uint32_t id = 0;
+    if (!free_items_.empty()) {
+      id = free_items_.back();
+      free_items_.pop_back();
+    } else {
+      treap_.emplace_back();
+      id = treap_.size() - 1;
+    }
+
+    auto& item = treap_[id];
+    item.weight = weight;
+    item.max_weight = weight;
+    item.combination_id = combination_id;
+    item.priority = random_();
+    item.left = NO_ITEM;
+    item.right = NO_ITEM;
+    item.size = 1;
+    return id;
+  }
+
+  void
+  push_back(type_weight weight, type_size combination_id) {
+    root_ = merge(root_, new_item(weight, combination_id));
+  }
+
+  type_weight
+  weight_at(type_size pos) const {
+    auto id = root_;
+    while (true) {
+      const auto& item = treap_[id];
+      const auto left_size = size_of(item.left);
+      if (pos < left_size) {
+        id = item.left;
+      } else if (pos == left_size) {
+        return item.weight;
+      } else {
+        pos -= left_size + 1;
+        id = item.right;
+      }
+    }
+  }
+
+  /** Find the position of the last item before @a end, in the sub-tree
+   * @a id, whose first item is at @a offset, whose weight is at least
+   * @a weight.
+   *
+   * This only descends into sub-trees whose maximum weight is big enough,
+   * so it takes O(log n) time.
+   */
+  bool
+  find_last_at_least(std::uint32_t id, type_size offset, type_size end,
+    type_weight weight, type_size& result) const {
+    if (id == NO_ITEM || max_weight_of(id) < weight || offset >= end) {
+      return false;
+    }
+
+    const auto& item = treap_[id];
+    const auto pos = offset + size_of(item.left);
+    if (pos < end) {
+      if (find_last_at_least(item.right, pos + 1, end, weight, result)) {
+        return true;
+      }
+
+      if (item.weight >= weight) {
+        result = pos;
+        return true;
+      }
+    }
+
+    return find_last_at_least(item.left, offset, end, weight, result);
+  }
+
+  const type_weights weights_;
+
+  std::vector<AlphabeticTree::Node> combinations_;
+  type_weight cost_ = 0;
+  std::vector<type_size> pending_;
+
+  std::vector<Item> treap_;
+  std::vector<std::uint32_t> free_items_;
+  std::uint32_t root_ = NO_ITEM;
+  std::minstd_rand random_;
+};
+
+/** Check that the tree is a full binary tree,
+ * whose leaves are the items in order,
+ * and whose cost is correct.
+ */
+static bool
+tree_is_valid(const AlphabeticTree& tree, const type_weights& weights) {
+  const auto n = weights.size();
+  if (n == 0) {
+    return tree.root == AlphabeticTree::NO_NODE && tree.cost == 0;
+  }
+
+  if (tree.nodes.size() != 2 * n - 1) {
+    return false;
+  }
+
+  // Traverse it in order, without recursion:
+  std::vector<type_size> leaves;
+  std::vector<type_size> stack;
+  auto id = tree.root;
+  while (id != AlphabeticTree::NO_NODE || !stack.empty()) {
+    if (id != AlphabeticTree::NO_NODE) {
+      if (id < n) {
+        leaves.emplace_back(id);
+        id = AlphabeticTree::NO_NODE;
+      } else {
+        stack.emplace_back(id);
+        id = tree.nodes[id].left;
+      }
+    } else {
+      id = tree.nodes[stack.back()].right;
+      stack.pop_back();
+    }
+  }
+
+  for (type_size i = 0; i < n; ++i) {
+    if (leaves.size() != n || leaves[i] != i) {
+      return false;
+    }
+  }
+
+  const auto depths = get_leaf_depths(tree, n);
+  type_weight cost = 0;
+  for (type_size i = 0; i < n; ++i) {
+    cost += weights[i] * depths[i];
+  }
+
+  return cost == tree.cost;
+}
+
+static void
+test_against_dp(const type_weights& weights) {
+  DpOptimalAlphabeticTree dp(weights);
+  dp.calc();
+  const auto expected = dp.get_tree();
+  assert(tree_is_valid(expected, weights));
+
+  GarsiaWachs gw(weights);
+  const auto result = gw.calc();
+  assert(tree_is_valid(result, weights));
+
+  assert(result.cost == expected.cost);
+}
+
+int
+main() {
+  const type_weights weights = {11, 10, 12, 22, 18};
+
+  std::cout << "Problem:" << std::endl << "  weights: ";
+  for (const auto& weight : weights) {
+    std::cout << weight << ", ";
+  }
+  std::cout << std::endl;
+
+  DpOptimalAlphabeticTree dp(weights);
+  const auto dp_result = dp.calc();
+  std::cout << "DP solution: cost: " << dp_result.value << std::endl;
+  std::cout << "  left sub-tree size: " << dp_result.left_size << std::endl;
+
+  GarsiaWachs gw(weights);
+  const auto result = gw.calc();
+  std::cout << "Garsia-Wachs solution: cost: " << result.cost << std::endl;
+  std::cout << "  leaf depths: ";
+  for (const auto depth : get_leaf_depths(result, weights.size())) {
+    std::cout << depth << ", ";
+  }
+  std::cout << std::endl;
+
+  assert(dp_result.value == 167);
+  assert(result.cost == 167);
+
+  GarsiaWachs gw_empty({});
+  assert(tree_is_valid(gw_empty.calc(), {}));
+
+  // Compare with the DP, as a reference, for many random inputs:
+  test_against_dp({5});
+  test_against_dp({1, 1, 1, 1, 1, 1, 1, 1});
+  test_against_dp({1, 2, 3, 4, 5, 6, 7, 8, 9});
+  test_against_dp({9, 8, 7, 6, 5, 4, 3, 2, 1});
+  std::mt19937 random(1);
+  for (type_size n = 1; n < 40; ++n) {
+    for (int attempt = 0; attempt < 5; ++attempt) {
+      std::uniform_int_distribution<type_weight> distribution(
+        1, attempt == 0 ? 3 : 1000);
+      type_weights random_weights(n);
+      for (auto& weight : random_weights) {
+        weight = distribution(random);
+      }
+
+      test_against_dp(random_weights);
+    }
+  }
+
+  // Something far too large for the DP:
+  const type_size large_n = 1000000;
+  type_weights large_weights(large_n);
+  std::uniform_int_distribution<type_weight> distribution(1, 1000000);
+  for (auto& weight : large_weights) {
+    weight = distribution(random);
+  }
+
+  std::cout << "Garsia-Wachs with " << large_n << " items:" << std::endl;
+  AlphabeticTree large_result;
+  {
+    boost::timer::auto_cpu_timer timer;
+    GarsiaWachs large_gw(large_weights);
+    large_result = large_gw.calc();
+  }
+  std::cout << "  cost: " << large_result.cost << std::endl;
+  assert(tree_is_valid(large_result, large_weights));
+
+  return EXIT_SUCCESS;
+}
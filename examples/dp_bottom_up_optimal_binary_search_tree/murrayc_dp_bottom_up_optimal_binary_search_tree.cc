@@ -19,11 +19,11 @@
 #include <iomanip>
 #include <iostream>
 #include <limits>
-#include <numeric>
 #include <string>
 #include <vector>
 
 #include <murraycdp/dp_bottom_up_base.h>
+#include <murraycdp/utils/range_aggregate.h>
 
 class ItemAndFrequency {
 public:
@@ -70,7 +70,10 @@ public:
   using type_size = type_items::size_type;
 
   DpOptimalBinarySearchTree(const type_items& items)
-  : DpBottomUpBase(items.size() + 1, items.size()), items_(items) {}
+  : DpBottomUpBase(items.size() + 1, items.size()),
+    items_(items),
+    freqs_(std::begin(items_), std::end(items_),
+      [](const auto& item) { return item.percentage; }) {}
 
 private:
   /**
@@ -101,9 +104,10 @@ private:
     // its frequency * its depth.
     // See https://youtu.be/u5eSBQQ4qVc?t=4m22s for Tim Roughgarden's more detailed explanation,
     // though it seems to hand-wave past this part.
-    const auto b = std::begin(items_) + i;
-    const auto freq_sum = std::accumulate(b, b + s, 0,
-      [](auto sum, const auto& item) { return sum + item.percentage; });
+    //
+    // This uses the prefix sums, instead of adding up the range every time,
+    // so we don't add another O(n) factor.
+    const auto freq_sum = freqs_.sum(i, i + s);
 
     // Get the min of possible subproblems: For every possible root (try i to
     // r-1 and r+1 to i+s)).
@@ -153,6 +157,9 @@ private:
   }
 
   const type_items items_;
+
+  // The frequencies, so we can get the sum of any range in O(1) time.
+  const murraycdp::utils::range_aggregate<type_value> freqs_;
 };
 
 int
@@ -0,0 +1,960 @@
+/* Copyright (C) 2016 Murray Cumming
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#include <algorithm>
+#include <boost/timer/timer.hpp>
+#include <cassert>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <murraycdp/dp_bottom_up_base.h>
+
+using type_cost = unsigned long long;
+using type_dimension = unsigned long long;
+
+/** The dimensions of the chain of matrices:
+ * Matrix k has dimensions[k] rows and dimensions[k + 1] columns,
+ * so n matrices have n + 1 dimensions.
+ */
+using type_dimensions = std::vector<type_dimension>;
+using type_size = type_dimensions::size_type;
+
+/**
+ * The order in which to multiply a chain of matrices.
+ *
+ * nodes[0] to nodes[n-1] are the matrices, in order.
+ * The other nodes are the products.
+ */
+class ParenthesizationTree {
+public:
+  static constexpr type_size NO_NODE = std::numeric_limits<type_size>::max();
+
+  class Node {
+  public:
+    type_size left = NO_NODE;
+    type_size right = NO_NODE;
+  };
+
+  /// The count of scalar multiplications.
+  type_cost cost = 0;
+  type_size root = NO_NODE;
+  std::vector<Node> nodes;
+
+  /** For instance, "((AB)C)".
+   */
+  std::string
+  to_string(const std::vector<std::string>& names) const {
+    if (root == NO_NODE) {
+      return std::string();
+    }
+
+    return to_string(names, root);
+  }
+
+private:
+  std::string
+  to_string(const std::vector<std::string>& names, type_size id) const {
+    if (id < names.size()) {
+      return names[id];
+    }
+
+    const auto& node = nodes[id];
+    return "(" + to_string(names, node.left) + to_string(names, node.right) +
+           ")";
+  }
+};
+
+/** Get the cost of multiplying the matrices in the order described by the
+ * tree, without using the tree's cost.
+ * This also checks that the tree has the matrices in their original order.
+ */
+static bool
+calc_tree_cost(const ParenthesizationTree& tree,
+  const type_dimensions& dimensions, type_cost& cost) {
+  cost = 0;
+  const auto n = dimensions.size() - 1;
+  if (tree.nodes.size() != 2 * n - 1) {
+    return false;
+  }
+
+  // The range of matrices, [first, last), for each node:
+  std::vector<std::pair<type_size, type_size>> ranges(tree.nodes.size());
+  for (type_size i = 0; i < n; ++i) {
+    ranges[i] = std::make_pair(i, i + 1);
+  }
+
+  // The products are always after their operands:
+  for (auto id = n; id < tree.nodes.size(); ++id) {
+    const auto& node = tree.nodes[id];
+    if (node.left >= id || node.right >= id) {
+      return false;
+    }
+
+    const auto& left = ranges[node.left];
+    const auto& right = ranges[node.right];
+    if (left.second != right.first) {
+      return false;
+    }
+
+    ranges[id] = std::make_pair(left.first, right.second);
+    cost += dimensions[left.first] * dimensions[left.second] *
+            dimensions[right.second];
+  }
+
+  return ranges[tree.root] == std::make_pair(type_size(0), n);
+}
+
+class SubProblem {
+public:
+  SubProblem() : cost(0), left_size(0) {}
+
+  explicit SubProblem(type_cost cost_in, type_size left_size_in)
+  : cost(cost_in), left_size(left_size_in) {}
+
+  SubProblem(const SubProblem& src) = default;
+  SubProblem&
+  operator=(const SubProblem& src) = default;
+
+  SubProblem(SubProblem&& src) noexcept = default;
+  SubProblem&
+  operator=(SubProblem&& src) noexcept = default;
+
+  type_cost cost;
+
+  /// The count of matrices in the left operand: The argmin.
+  type_size left_size;
+};
+
+/**
+ * The classic O(n^3) matrix-chain ordering, filling a table of the costs
+ * for each length (s) and start (i) of a sub-chain,
+ * with the best split (the argmin) for each.
+ *
+ * Unlike DpParenthesization, this doesn't build a solution string,
+ * or concatenate names, for every sub-problem.
+ * Instead get_tree() uses the splits afterwards.
+ *
+ * This is the reference for DpHuShing, and a baseline for its benchmark.
+ */
+class DpBottomUpParenthesization
+  : public murraycdp::DpBottomUpBase<0, /* keep all subproblems */
+      SubProblem, type_size, type_size> {
+public:
+  explicit DpBottomUpParenthesization(const type_dimensions& dimensions)
+  : DpBottomUpBase(dimensions.size(), dimensions.size() - 1),
+    dimensions_(dimensions) {}
+
+  /** Get the tree, after calling calc().
+   */
+  ParenthesizationTree
+  get_tree() const {
+    ParenthesizationTree result;
+    const auto n = dimensions_.size() - 1;
+    result.nodes.resize(n);
+
+    type_size s = 0;
+    type_size i = 0;
+    get_goal_cell(s, i);
+
+    type_level level = 0;
+    result.cost = get_subproblem(level, s, i).cost;
+    result.root = add_nodes(result, s, i);
+    return result;
+  }
+
+private:
+  type_subproblem
+  calc_subproblem(type_level level, type_size s, type_size i) const override {
+    // Base case: A single matrix, or nothing:
+    if (s <= 1) {
+      return type_subproblem(0, 0);
+    }
+
+    if (i + s >= dimensions_.size()) {
+      return type_subproblem(0, 0);
+    }
+
+    auto min = std::numeric_limits<type_cost>::max();
+    type_size left_size_for_min = 0;
+    for (type_size left_size = 1; left_size < s; ++left_size) {
+      const auto left = get_subproblem(level, left_size, i);
+      const auto right = get_subproblem(level, s - left_size, i + left_size);
+      const auto cost = left.cost + right.cost +
+                        dimensions_[i] * dimensions_[i + left_size] *
+                          dimensions_[i + s];
+      if (cost < min) {
+        min = cost;
+        left_size_for_min = left_size;
+      }
+    }
+
+    return type_subproblem(min, left_size_for_min);
+  }
+
+  void
+  get_goal_cell(type_size& s, type_size& i) const override {
+    // The answer is in the last-calculated cell:
+    s = dimensions_.size() - 1;
+    i = 0;
+  }
+
+  type_size
+  add_nodes(ParenthesizationTree& tree, type_size s, type_size i) const {
+    if (s == 1) {
+      return i;
+    }
+
+    type_level level = 0;
+    const auto left_size = get_subproblem(level, s, i).left_size;
+
+    ParenthesizationTree::Node node;
+    node.left = add_nodes(tree, left_size, i);
+    node.right = add_nodes(tree, s - left_size, i + left_size);
+    tree.nodes.emplace_back(node);
+    return tree.nodes.size() - 1;
+  }
+
+  const type_dimensions dimensions_;
+};
+
+/**
+ * Matrix-chain ordering via Hu and Shing's polygon partitioning,
+ * without filling an O(n^2) table.
+ *
+ * The n + 1 dimensions are the weights of the vertices of a convex polygon,
+ * and each ordering is a partition of the polygon into triangles,
+ * whose cost is the sum of the products of each triangle's weights.
+ *
+ * Hu and Shing showed that there is an optimal partition made only of
+ * "h-arcs", between two vertices that are both lighter than every vertex
+ * between them, and fans from the lightest vertex of each region that
+ * the h-arcs leave. So this
+ * - Finds the O(n) potential h-arcs, with one sweep around the polygon,
+ *   starting from the lightest vertex. They are nested, so they form a tree.
+ * - Decides which h-arcs to use, bottom-up. The cost below an h-arc depends
+ *   only on whether we use it, and on the weight w of the lightest vertex of
+ *   the region above it (the apex), which is lighter than all the vertices
+ *   below the arc.
+ * - Fans out each remaining region, and turns the triangles into the tree.
+ *
+ * The cost below an h-arc is the minimum of the cost with the arc, which is
+ * a line, w * (the arc's product) + (the cost above the arc), and the cost
+ * without it, which is w * (the product of each side) + (the sum of the
+ * children's costs). So it is a concave, piecewise-linear, function of w.
+ * We only need it at whole weights, so its breakpoints (Hu and Shing's
+ * "supporting weights") are whole too. Each arc keeps its function as its
+ * value and slope at the weight of its lighter vertex, above which no apex
+ * can be, with a leftist heap of the breakpoints below. The heaps of the
+ * children are melded, and the line then replaces the breakpoints above the
+ * lightest apex for which the arc is worth using, which are popped. The
+ * slope of the cost without the arc is never less than the arc's product,
+ * so the arc is used for apexes at least as heavy as that threshold.
+ *
+ * Each breakpoint is pushed and popped at most once, and each heap is melded
+ * once, so this takes O(n log n) time, and O(n) memory.
+ *
+ * See T. C. Hu and M. T. Shing, Computation of Matrix Chain Products,
+ * Parts I and II, SIAM Journal on Computing, 1982 and 1984.
+ */
+class DpHuShing {
+public:
+  explicit DpHuShing(const type_dimensions& dimensions)
+  : dimensions_(dimensions) {}
+
+  ParenthesizationTree
+  calc() {
+    assert(dimensions_.size() >= 2);
+
+    vertices_count_ = dimensions_.size();
+    lightest_ = 0;
+    for (type_size v = 1; v < vertices_count_; ++v) {
+      if (dimensions_[v] < dimensions_[lightest_]) {
+        lightest_ = v;
+      }
+    }
+
+    find_arcs();
+    calc_arc_costs();
+
+    triangles_.clear();
+    fan_regions();
+
+    auto result = build_tree();
+    result.cost = cost_;
+    return result;
+  }
+
+private:
+  static constexpr type_size NO_BREAKPOINT =
+    std::numeric_limits<type_size>::max();
+
+  /** A weight at which the slope of a cost function changes,
+   * in a leftist heap, with the heaviest weight at the top.
+   */
+  class Breakpoint {
+  public:
+    type_cost weight = 0;
+
+    // How much more the slope is below this weight:
+    type_cost slope_change = 0;
+
+    type_size left = NO_BREAKPOINT;
+    type_size right = NO_BREAKPOINT;
+
+    // The length of the shortest path down to a missing child:
+    type_size rank = 1;
+  };
+
+  /** The cost below an arc, for each weight of the apex above it, up to the
+   * top weight.
+   */
+  class CostFunction {
+  public:
+    type_cost top = 0;
+    type_cost value = 0; // At the top.
+    type_cost slope = 0; // Just below the top.
+    type_size breakpoints = NO_BREAKPOINT; // Below the top.
+  };
+
+  /** A potential h-arc, between two positions around the polygon.
+   * Position 0, and position n + 1, are both the lightest vertex.
+   */
+  class Arc {
+  public:
+    type_size first = 0;
+    type_size last = 0;
+    type_size lighter = 0; // vertex
+
+    std::vector<type_size> children;
+
+    // The cost above the arc, whose apex is then its lighter vertex.
+    type_cost cost_above = 0;
+
+    // We use the arc if the apex is at least this heavy,
+    // or if the apex is its lighter vertex, when both choices are the same.
+    type_cost threshold = 0;
+
+    CostFunction cost_function;
+  };
+
+  type_size
+  vertex_at(type_size pos) const {
+    return (lightest_ + pos) % vertices_count_;
+  }
+
+  type_cost
+  weight(type_size vertex) const {
+    return dimensions_[vertex];
+  }
+
+  /** Compare the weights of positions, breaking ties by vertex,
+   * so the weights are all different,
+   * apart from positions 0 and n + 1, which are the same vertex.
+   */
+  bool
+  is_heavier(type_size pos_a, type_size pos_b) const {
+    const auto a = vertex_at(pos_a);
+    const auto b = vertex_at(pos_b);
+    if (weight(a) != weight(b)) {
+      return weight(a) > weight(b);
+    }
+
+    return a > b;
+  }
+
+  void
+  add_arc(type_size first, type_size last) {
+    // Sides of the polygon are not arcs:
+    const auto end = vertices_count_; // The lightest vertex, again.
+    if (last - first < 2 || (first == 0 && last == end - 1) ||
+        (first == 1 && last == end) || (first == 0 && last == end)) {
+      return;
+    }
+
+    Arc arc;
+    arc.first = first;
+    arc.last = last;
+    const auto a = vertex_at(first);
+    const auto b = vertex_at(last);
+    arc.lighter = is_heavier(first, last) ? b : a;
+    arcs_.emplace_back(arc);
+  }
+
+  /** Find the potential h-arcs with one sweep around the polygon,
+   * keeping a stack of the vertices that are still visible.
+   * Then nest them in a tree, whose root (arcs_[0]) is the whole polygon.
+   */
+  void
+  find_arcs() {
+    arcs_.clear();
+
+    Arc root;
+    root.first = 0;
+    root.last = vertices_count_;
+    root.lighter = lightest_;
+    arcs_.emplace_back(root);
+
+    std::vector<type_size> stack;
+    for (type_size pos = 0; pos <= vertices_count_; ++pos) {
+      while (!stack.empty() && is_heavier(stack.back(), pos)) {
+        add_arc(stack.back(), pos);
+        stack.pop_back();
+      }
+
+      if (!stack.empty()) {
+        add_arc(stack.back(), pos);
+      }
+
+      stack.emplace_back(pos);
+    }
+
+    // Sort so that each arc is after the arcs that contain it,
+    // and its children are in order:
+    std::sort(arcs_.begin() + 1, arcs_.end(), [](const Arc& a, const Arc& b) {
+      return a.first != b.first ? a.first < b.first : a.last > b.last;
+    });
+
+    std::vector<type_size> containers;
+    containers.emplace_back(0);
+    for (type_size id = 1; id < arcs_.size(); ++id) {
+      while (arcs_[containers.back()].last <= arcs_[id].first) {
+        containers.pop_back();
+      }
+
+      assert(arcs_[id].last <= arcs_[containers.back()].last);
+      arcs_[containers.back()].children.emplace_back(id);
+      containers.emplace_back(id);
+    }
+  }
+
+  /** Call @a on_side for each side of the polygon, with its two vertices,
+   * and @a on_child for each child arc, with its index, around the boundary
+   * above the arc, in order.
+   */
+  template <typename T_on_side, typename T_on_child>
+  void
+  for_each_boundary_part(
+    const Arc& arc, T_on_side on_side, T_on_child on_child) const {
+    auto pos = arc.first;
+    for (const auto child_id : arc.children) {
+      const auto& child = arcs_[child_id];
+      for (; pos < child.first; ++pos) {
+        on_side(vertex_at(pos), vertex_at(pos + 1));
+      }
+
+      on_child(child_id);
+      pos = child.last;
+    }
+
+    for (; pos < arc.last; ++pos) {
+      on_side(vertex_at(pos), vertex_at(pos + 1));
+    }
+  }
+
+  bool
+  touches(const Arc& arc, type_size vertex) const {
+    return vertex_at(arc.first) == vertex || vertex_at(arc.last) == vertex;
+  }
+
+  /** Whether we use the arc, if the region above its parent has this apex.
+   */
+  bool
+  is_used(const Arc& arc, type_size apex) const {
+    return apex == arc.lighter || weight(apex) >= arc.threshold;
+  }
+
+  type_size
+  meld_breakpoints(type_size a, type_size b) {
+    if (a == NO_BREAKPOINT) {
+      return b;
+    }
+
+    if (b == NO_BREAKPOINT) {
+      return a;
+    }
+
+    if (breakpoints_[a].weight < breakpoints_[b].weight) {
+      std::swap(a, b);
+    }
+
+    // The right path is the shortest, so this recursion is only
+    // O(log(n)) deep:
+    const auto right = meld_breakpoints(breakpoints_[a].right, b);
+    auto& breakpoint = breakpoints_[a];
+    breakpoint.right = right;
+
+    const auto left_rank = (breakpoint.left == NO_BREAKPOINT)
+                             ? 0
+                             : breakpoints_[breakpoint.left].rank;
+    if (left_rank < breakpoints_[right].rank) {
+      std::swap(breakpoint.left, breakpoint.right);
+    }
+
+    breakpoint.rank = (breakpoint.right == NO_BREAKPOINT)
+                        ? 1
+                        : breakpoints_[breakpoint.right].rank + 1;
+    return a;
+  }
+
+  void
+  add_breakpoint(CostFunction& f, type_cost weight, type_cost slope_change) {
+    if (slope_change == 0) {
+      return;
+    }
+
+    Breakpoint breakpoint;
+    breakpoint.weight = weight;
+    breakpoint.slope_change = slope_change;
+    breakpoints_.emplace_back(breakpoint);
+    f.breakpoints = meld_breakpoints(f.breakpoints, breakpoints_.size() - 1);
+  }
+
+  /** Lower the top of the cost function, getting its value there,
+   * and forgetting the breakpoints that are then not below the top.
+   */
+  void
+  move_top(CostFunction& f, type_cost top) {
+    assert(top <= f.top);
+
+    while (f.breakpoints != NO_BREAKPOINT &&
+           breakpoints_[f.breakpoints].weight >= top) {
+      const auto& breakpoint = breakpoints_[f.breakpoints];
+      f.value -= f.slope * (f.top - breakpoint.weight);
+      f.top = breakpoint.weight;
+      f.slope += breakpoint.slope_change;
+      f.breakpoints = meld_breakpoints(breakpoint.left, breakpoint.right);
+    }
+
+    f.value -= f.slope * (f.top - top);
+    f.top = top;
+  }
+
+  /** Replace the cost function with the line, for the weights at which the
+   * line is not more, which must be at the top, if anywhere.
+   * @result The lightest weight at which the line is not more.
+   */
+  type_cost
+  take_min_with_line(
+    CostFunction& f, type_cost line_slope, type_cost line_value) {
+    if (line_value > f.value) {
+      // Then it is more for any lighter weight too:
+      return f.top + 1;
+    }
+
+    // Go down until the line is more, popping the breakpoints on the way:
+    auto pos = f.top;
+    auto value = f.value;
+    auto slope = f.slope;
+    auto line_value_at_pos = line_value;
+    while (true) {
+      assert(line_slope <= slope);
+      assert(line_value_at_pos <= value);
+
+      const auto next = (f.breakpoints == NO_BREAKPOINT)
+                          ? 0
+                          : breakpoints_[f.breakpoints].weight;
+
+      // The line is not more, for this much further down:
+      const auto difference = value - line_value_at_pos;
+      const auto slope_difference = slope - line_slope;
+      if (slope_difference == 0 ||
+          difference / slope_difference >= pos - next) {
+        if (f.breakpoints == NO_BREAKPOINT) {
+          // The line is not more for any weight:
+          f.value = line_value;
+          f.slope = line_slope;
+          return 0;
+        }
+
+        const auto& breakpoint = breakpoints_[f.breakpoints];
+        value -= slope * (pos - next);
+        line_value_at_pos -= line_slope * (pos - next);
+        pos = next;
+        slope += breakpoint.slope_change;
+        f.breakpoints = meld_breakpoints(breakpoint.left, breakpoint.right);
+        continue;
+      }
+
+      // The line is more just below the threshold, so we join its value at
+      // the threshold to the function's value just below it:
+      const auto threshold = pos - difference / slope_difference;
+      const auto line_value_at_threshold =
+        line_value_at_pos - line_slope * (pos - threshold);
+      const auto value_below = value - slope * (pos - threshold + 1);
+      const auto join_slope = line_value_at_threshold - value_below;
+
+      f.value = line_value;
+      f.slope = line_slope;
+      add_breakpoint(f, threshold, join_slope - line_slope);
+      add_breakpoint(f, threshold - 1, slope - join_slope);
+      move_top(f, f.top);
+      return threshold;
+    }
+  }
+
+  void
+  calc_arc_costs() {
+    breakpoints_.clear();
+
+    // Bottom-up, because children are always after their parents:
+    for (auto id = arcs_.size(); id-- > 0;) {
+      auto& arc = arcs_[id];
+      const auto apex = arc.lighter;
+      const auto top = weight(apex);
+
+      // The cost above the arc, whose apex is its lighter vertex, and the
+      // cost without the arc, for an apex that is lighter still:
+      type_cost cost_above = 0;
+      auto& without_arc = arc.cost_function;
+      without_arc.top = top;
+      for_each_boundary_part(arc,
+        [this, apex, top, &cost_above, &without_arc](
+          type_size a, type_size b) {
+          const auto product = weight(a) * weight(b);
+          if (a != apex && b != apex) {
+            cost_above += top * product;
+          }
+
+          without_arc.value += top * product;
+          without_arc.slope += product;
+        },
+        [this, apex, top, &cost_above, &without_arc](type_size child_id) {
+          auto& child = arcs_[child_id];
+          auto& child_function = child.cost_function;
+          move_top(child_function, top);
+          cost_above +=
+            touches(child, apex) ? child.cost_above : child_function.value;
+
+          without_arc.value += child_function.value;
+          without_arc.slope += child_function.slope;
+          without_arc.breakpoints = meld_breakpoints(
+            without_arc.breakpoints, child_function.breakpoints);
+          child_function.breakpoints = NO_BREAKPOINT;
+        });
+
+      arc.cost_above = cost_above;
+      if (id == 0) {
+        // The whole polygon, whose apex is the lightest vertex:
+        cost_ = cost_above;
+        break;
+      }
+
+      const auto arc_product =
+        weight(vertex_at(arc.first)) * weight(vertex_at(arc.last));
+      arc.threshold = take_min_with_line(
+        without_arc, arc_product, top * arc_product + cost_above);
+    }
+  }
+
+  /** Partition the region above each arc that we use with a fan from its
+   * lightest vertex, going around its boundary, and continuing above the
+   * arcs that we don't use.
+   */
+  void
+  fan_regions() {
+    class Walk {
+    public:
+      type_size arc_id;
+      type_size child_index;
+      type_size pos;
+    };
+
+    std::vector<type_size> regions = {0};
+    std::vector<type_size> boundary;
+    std::vector<Walk> walks;
+    while (!regions.empty()) {
+      const auto region_id = regions.back();
+      regions.pop_back();
+      const auto& region = arcs_[region_id];
+      const auto apex = region.lighter;
+
+      // Walk around the boundary, going below the arcs that we don't use,
+      // without recursion:
+      boundary.assign(1, vertex_at(region.first));
+      walks.push_back({region_id, 0, region.first});
+      while (!walks.empty()) {
+        auto& walk = walks.back();
+        const auto& arc = arcs_[walk.arc_id];
+        if (walk.child_index == arc.children.size()) {
+          for (; walk.pos < arc.last; ++walk.pos) {
+            boundary.emplace_back(vertex_at(walk.pos + 1));
+          }
+
+          walks.pop_back();
+          continue;
+        }
+
+        const auto child_id = arc.children[walk.child_index];
+        const auto& child = arcs_[child_id];
+        for (; walk.pos < child.first; ++walk.pos) {
+          boundary.emplace_back(vertex_at(walk.pos + 1));
+        }
+
+        ++walk.child_index;
+        walk.pos = child.last;
+        if (is_used(child, apex)) {
+          boundary.emplace_back(vertex_at(child.last));
+          regions.emplace_back(child_id);
+        } else {
+          // This invalidates walk:
+          walks.push_back({child_id, 0, child.first});
+        }
+      }
+
+      for (type_size i = 0; i + 1 < boundary.size(); ++i) {
+        const auto a = boundary[i];
+        const auto b = boundary[i + 1];
+        if (a != apex && b != apex) {
+          add_triangle(apex, a, b);
+        }
+      }
+    }
+  }
+
+  void
+  add_triangle(type_size a, type_size b, type_size c) {
+    // The triangle splits the chain between its first and last vertices:
+    type_size vertices[] = {a, b, c};
+    std::sort(std::begin(vertices), std::end(vertices));
+    triangles_[vertices[0] * vertices_count_ + vertices[2]] = vertices[1];
+  }
+
+  ParenthesizationTree
+  build_tree() const {
+    ParenthesizationTree result;
+    const auto n = vertices_count_ - 1;
+    result.nodes.resize(n);
+
+    // Post-order, without recursion, so each product is after its operands:
+    class Range {
+    public:
+      type_size first;
+      type_size last;
+      bool expanded;
+    };
+
+    std::vector<Range> stack;
+    std::vector<type_size> ids;
+    stack.push_back({0, n, false});
+    while (!stack.empty()) {
+      const auto range = stack.back();
+      stack.pop_back();
+
+      if (range.last - range.first == 1) {
+        ids.emplace_back(range.first);
+        continue;
+      }
+
+      const auto iter = triangles_.find(range.first * vertices_count_ + range.last);
+      assert(iter != triangles_.end());
+      const auto split = iter->second;
+      if (!range.expanded) {
+        stack.push_back({range.first, range.last, true});
+        stack.push_back({split, range.last, false});
+        stack.push_back({range.first, split, false});
+        continue;
+      }
+
+      ParenthesizationTree::Node node;
+      node.right = ids.back();
+      ids.pop_back();
+      node.left = ids.back();
+      ids.pop_back();
+      result.nodes.emplace_back(node);
+      ids.emplace_back(result.nodes.size() - 1);
+    }
+
+    result.root = ids.back();
+    return result;
+  }
+
+  const type_dimensions dimensions_;
+  type_size vertices_count_ = 0;
+  type_size lightest_ = 0;
+
+  std::vector<Arc> arcs_;
+  std::vector<Breakpoint> breakpoints_;
+  type_cost cost_ = 0;
+
+  // The middle vertex of the triangle for each chain.
+  std::unordered_map<type_size, type_size> triangles_;
+};
+
+constexpr type_size DpHuShing::NO_BREAKPOINT;
+
+static void
+test_against_dp(const type_dimensions& dimensions) {
+  DpBottomUpParenthesization dp(dimensions);
+  dp.calc();
+  const auto expected = dp.get_tree();
+
+  type_cost cost = 0;
+  assert(calc_tree_cost(expected, dimensions, cost));
+  assert(cost == expected.cost);
+
+  DpHuShing hu_shing(dimensions);
+  const auto result = hu_shing.calc();
+  assert(calc_tree_cost(result, dimensions, cost));
+  assert(cost == result.cost);
+
+  assert(result.cost == expected.cost);
+}
+
+static type_dimensions
+random_dimensions(type_size n, type_dimension max, std::mt19937& random) {
+  std::uniform_int_distribution<type_dimension> distribution(1, max);
+  type_dimensions result(n + 1);
+  for (auto& dimension : result) {
+    dimension = distribution(random);
+  }
+
+  return result;
+}
+
+/** Dimensions that go up from 1 to @a peak, and back down to 1,
+ * or, for a valley, down from @a peak to 1 and back up, so most arcs are
+ * nested inside many others.
+ */
+static type_dimensions
+mountain_dimensions(type_dimension peak, bool valley) {
+  type_dimensions result;
+  for (type_dimension d = 1; d <= peak; ++d) {
+    result.emplace_back(valley ? peak + 1 - d : d);
+  }
+
+  for (type_dimension d = peak; d >= 1; --d) {
+    result.emplace_back(valley ? peak + 1 - d : d);
+  }
+
+  return result;
+}
+
+int
+main() {
+  // As in the top-down DpParenthesization example:
+  const type_dimensions dimensions = {10, 30, 5, 60};
+  const std::vector<std::string> names = {"A", "B", "C"};
+
+  DpBottomUpParenthesization dp(dimensions);
+  dp.calc();
+  const auto dp_result = dp.get_tree();
+  std::cout << "DP result: " << dp_result.cost << ": "
+            << dp_result.to_string(names) << std::endl;
+
+  DpHuShing hu_shing(dimensions);
+  const auto result = hu_shing.calc();
+  std::cout << "Hu-Shing result: " << result.cost << ": "
+            << result.to_string(names) << std::endl;
+
+  assert(dp_result.cost == 4500);
+  assert(dp_result.to_string(names) == "((AB)C)");
+  assert(result.cost == 4500);
+  assert(result.to_string(names) == "((AB)C)");
+
+  // Compare with the DP, as a reference, for many random inputs,
+  // including inputs with many equal dimensions:
+  test_against_dp({7, 3});
+  test_against_dp({1, 2, 3, 4, 5, 6, 7});
+  test_against_dp({7, 6, 5, 4, 3, 2, 1});
+  test_against_dp({5, 5, 5, 5, 5, 5});
+  std::mt19937 random(1);
+  for (type_size n = 1; n < 16; ++n) {
+    for (int attempt = 0; attempt < 200; ++attempt) {
+      test_against_dp(random_dimensions(n, attempt % 2 ? 4 : 1000, random));
+    }
+  }
+
+  for (type_dimension peak = 1; peak < 40; ++peak) {
+    test_against_dp(mountain_dimensions(peak, false));
+    test_against_dp(mountain_dimensions(peak, true));
+  }
+
+  // Random mountains, with the dimensions sorted up to a random peak,
+  // and then down:
+  for (type_size n = 2; n < 60; ++n) {
+    for (int attempt = 0; attempt < 20; ++attempt) {
+      auto mountain = random_dimensions(n, attempt % 2 ? 20 : 1000, random);
+      const auto peak = mountain.begin() + random() % mountain.size();
+      std::sort(mountain.begin(), peak);
+      std::sort(peak, mountain.end(), std::greater<type_dimension>());
+      test_against_dp(mountain);
+    }
+  }
+
+  // Benchmark against the O(n^3) DP:
+  const type_size benchmark_n = 200;
+  const auto benchmark_dimensions =
+    random_dimensions(benchmark_n, 1000, random);
+  std::cout << "DP with " << benchmark_n << " matrices:" << std::endl;
+  type_cost benchmark_dp_cost = 0;
+  {
+    boost::timer::auto_cpu_timer timer;
+    DpBottomUpParenthesization benchmark_dp(benchmark_dimensions);
+    benchmark_dp_cost = benchmark_dp.calc().cost;
+  }
+
+  std::cout << "Hu-Shing with " << benchmark_n << " matrices:" << std::endl;
+  type_cost benchmark_cost = 0;
+  {
+    boost::timer::auto_cpu_timer timer;
+    DpHuShing benchmark_hu_shing(benchmark_dimensions);
+    benchmark_cost = benchmark_hu_shing.calc().cost;
+  }
+  assert(benchmark_cost == benchmark_dp_cost);
+
+  // Something far too large for the DP:
+  const type_size large_n = 100000;
+  const auto large_dimensions = random_dimensions(large_n, 1000, random);
+  std::cout << "Hu-Shing with " << large_n << " matrices:" << std::endl;
+  ParenthesizationTree large_result;
+  {
+    boost::timer::auto_cpu_timer timer;
+    DpHuShing large_hu_shing(large_dimensions);
+    large_result = large_hu_shing.calc();
+  }
+
+  type_cost large_cost = 0;
+  assert(calc_tree_cost(large_result, large_dimensions, large_cost));
+  assert(large_cost == large_result.cost);
+  std::cout << "  cost: " << large_result.cost << std::endl;
+
+  // A mountain, whose arcs are all nested, so each one's region is above
+  // O(n) others:
+  const type_dimension mountain_peak = 30000;
+  const auto mountain = mountain_dimensions(mountain_peak, false);
+  std::cout << "Hu-Shing with a mountain of " << mountain.size() - 1
+            << " matrices:" << std::endl;
+  ParenthesizationTree mountain_result;
+  {
+    boost::timer::auto_cpu_timer timer;
+    DpHuShing mountain_hu_shing(mountain);
+    mountain_result = mountain_hu_shing.calc();
+  }
+
+  type_cost mountain_cost = 0;
+  assert(calc_tree_cost(mountain_result, mountain, mountain_cost));
+  assert(mountain_cost == mountain_result.cost);
+  std::cout << "  cost: " << mountain_result.cost << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,962 @@
+/* Copyright (C) 2016 Murray Cumming
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#include <algorithm>
+#include <boost/timer/timer.hpp>
+#include <cassert>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/** Rule names, and the rules (or words) that each rule can produce.
+ * Unlike a map, this allows several productions for the same rule.
+ */
+using Rules = std::vector<std::pair<std::string, std::vector<std::string>>>;
+
+/**
+ * A context-free grammar, in Chomsky normal form, compiled so that
+ * BitsetCykParser can parse many sentences with it quickly.
+ *
+ * The nonterminals are interned to dense ids, so a set of nonterminals
+ * is a bitset of nonterminals_count() bits, in words_per_set() words.
+ * For each pair of nonterminals, (B, C), there is a bitset of the
+ * nonterminals, A, that have a rule A ::= B C.
+ */
+class CompiledGrammar {
+public:
+  using type_id = std::uint32_t;
+  using type_word = std::uint64_t;
+  using type_size = std::vector<type_word>::size_type;
+
+  static constexpr type_id NO_ID = std::numeric_limits<type_id>::max();
+  static constexpr type_size BITS_PER_WORD =
+    std::numeric_limits<type_word>::digits;
+
+  /** A rule A ::= B C.
+   */
+  class BinaryRule {
+  public:
+    type_id b = NO_ID;
+    type_id c = NO_ID;
+
+    /// The rule's position in the nonterminal_rules.
+    type_size index = 0;
+  };
+
+  /**
+   * @param nonterminal_rules Rules that produce two other rules.
+   * @param terminals Rules that produce one of some words.
+   * @param start_name The name of the rule that must produce the whole
+   * sentence.
+   */
+  CompiledGrammar(const Rules& nonterminal_rules, const Rules& terminals,
+    const std::string& start_name) {
+    // Intern all the names first, so we know the size of the bitsets:
+    intern(start_name);
+    for (const auto& rule : nonterminal_rules) {
+      intern(rule.first);
+      for (const auto& name : rule.second) {
+        intern(name);
+      }
+    }
+
+    for (const auto& rule : terminals) {
+      intern(rule.first);
+    }
+
+    words_per_set_ = (names_.size() + BITS_PER_WORD - 1) / BITS_PER_WORD;
+    const auto count = names_.size();
+
+    // The nonterminals that can produce each word:
+    for (const auto& rule : terminals) {
+      const auto id = nonterminal_ids_[rule.first];
+      for (const auto& word : rule.second) {
+        const auto inserted = terminal_ids_.emplace(word, terminal_ids_.size());
+        if (inserted.second) {
+          terminal_sets_.resize(terminal_sets_.size() + words_per_set_);
+        }
+
+        set_bit(&terminal_sets_[inserted.first->second * words_per_set_], id);
+      }
+    }
+
+    // The nonterminals that can produce each pair:
+    right_sets_.assign(count * words_per_set_, 0);
+    producer_set_ids_.assign(count * count, NO_ID);
+    rules_by_producer_.resize(count);
+    for (type_size index = 0; index < nonterminal_rules.size(); ++index) {
+      const auto& rule = nonterminal_rules[index];
+      if (rule.second.size() != 2) {
+        std::cerr << "Incorrect number of produced rules for rule: "
+                  << rule.first << std::endl;
+        continue;
+      }
+
+      const auto a = nonterminal_ids_[rule.first];
+      const auto b = nonterminal_ids_[rule.second[0]];
+      const auto c = nonterminal_ids_[rule.second[1]];
+      set_bit(&right_sets_[b * words_per_set_], c);
+
+      auto& set_id = producer_set_ids_[b * count + c];
+      if (set_id == NO_ID) {
+        set_id = producer_sets_.size() / words_per_set_;
+        producer_sets_.resize(producer_sets_.size() + words_per_set_);
+      }
+
+      set_bit(&producer_sets_[set_id * words_per_set_], a);
+
+      BinaryRule binary_rule;
+      binary_rule.b = b;
+      binary_rule.c = c;
+      binary_rule.index = index;
+      rules_by_producer_[a].emplace_back(binary_rule);
+    }
+  }
+
+  CompiledGrammar(const CompiledGrammar& src) = default;
+  CompiledGrammar&
+  operator=(const CompiledGrammar& src) = default;
+
+  CompiledGrammar(CompiledGrammar&& src) noexcept = default;
+  CompiledGrammar&
+  operator=(CompiledGrammar&& src) noexcept = default;
+
+  type_size
+  nonterminals_count() const {
+    return names_.size();
+  }
+
+  type_size
+  words_per_set() const {
+    return words_per_set_;
+  }
+
+  /** The start rule always has id 0.
+   */
+  type_id
+  start_id() const {
+    return 0;
+  }
+
+  /** Get the id of the nonterminal, or NO_ID.
+   */
+  type_id
+  get_nonterminal_id(const std::string& name) const {
+    const auto iter = nonterminal_ids_.find(name);
+    return iter == nonterminal_ids_.end() ? NO_ID : iter->second;
+  }
+
+  const std::string&
+  get_nonterminal_name(type_id id) const {
+    return names_[id];
+  }
+
+  /** Get the id of the word, or NO_ID if no rule produces it.
+   */
+  type_id
+  get_terminal_id(const std::string& word) const {
+    const auto iter = terminal_ids_.find(word);
+    return iter == terminal_ids_.end() ? NO_ID : iter->second;
+  }
+
+  /** The set of nonterminals that produce the word.
+   */
+  const type_word*
+  get_terminal_set(type_id terminal_id) const {
+    return &terminal_sets_[terminal_id * words_per_set_];
+  }
+
+  /** The set of nonterminals, C, that have rules A ::= B C.
+   */
+  const type_word*
+  get_right_set(type_id b) const {
+    return &right_sets_[b * words_per_set_];
+  }
+
+  /** The set of nonterminals, A, that have rules A ::= B C,
+   * which will not be empty if C is in get_right_set(b).
+   */
+  const type_word*
+  get_producer_set(type_id b, type_id c) const {
+    const auto set_id = producer_set_ids_[b * names_.size() + c];
+    assert(set_id != NO_ID);
+    return &producer_sets_[set_id * words_per_set_];
+  }
+
+  /** The rules A ::= B C for the nonterminal A.
+   */
+  const std::vector<BinaryRule>&
+  get_rules(type_id a) const {
+    return rules_by_producer_[a];
+  }
+
+  static bool
+  get_bit(const type_word* set, type_id id) {
+    return (set[id / BITS_PER_WORD] >> (id % BITS_PER_WORD)) & 1;
+  }
+
+  static void
+  set_bit(type_word* set, type_id id) {
+    set[id / BITS_PER_WORD] |= type_word(1) << (id % BITS_PER_WORD);
+  }
+
+private:
+  void
+  intern(const std::string& name) {
+    const auto inserted = nonterminal_ids_.emplace(name, names_.size());
+    if (inserted.second) {
+      names_.emplace_back(name);
+    }
+  }
+
+  std::unordered_map<std::string, type_id> nonterminal_ids_;
+  std::vector<std::string> names_;
+  type_size words_per_set_ = 0;
+
+  std::unordered_map<std::string, type_id> terminal_ids_;
+  std::vector<type_word> terminal_sets_;
+
+  std::vector<type_word> right_sets_;
+  std::vector<type_id> producer_set_ids_;
+  std::vector<type_word> producer_sets_;
+
+  std::vector<std::vector<BinaryRule>> rules_by_producer_;
+};
+
+constexpr CompiledGrammar::type_id CompiledGrammar::NO_ID;
+constexpr CompiledGrammar::type_size CompiledGrammar::BITS_PER_WORD;
+
+/**
+ * A shared packed parse forest (SPPF): All the derivations of a sentence,
+ * without repeating the derivations of any span.
+ *
+ * There is one node for each span and nonterminal that is in at least one
+ * derivation, and it has one packed node for each way to derive it: A rule,
+ * a split, and the child nodes for the two parts, referenced by their
+ * indices. The nodes are all in one arena, so copying the forest is cheap,
+ * and nothing is built for the derivations until it is needed.
+ *
+ * A derivation is a choice of packed node for each node.
+ * See BitsetCykParser::get_forest().
+ */
+class ParseForest {
+public:
+  using type_id = CompiledGrammar::type_id;
+  using type_size = CompiledGrammar::type_size;
+  using type_count = unsigned long long;
+  using type_choices = std::vector<type_size>;
+
+  static constexpr type_id NO_ID = CompiledGrammar::NO_ID;
+
+  /** A rule position, in the nonterminal_rules, for no rule.
+   * This is a different index than the nonterminal ids.
+   */
+  static constexpr type_size NO_RULE = std::numeric_limits<type_size>::max();
+
+  class Node {
+  public:
+    type_size first = 0;
+    type_size last = 0;
+    type_id nonterminal = NO_ID;
+
+    /// The packed nodes are [packed_begin, packed_end) in packed_nodes().
+    type_size packed_begin = 0;
+    type_size packed_end = 0;
+  };
+
+  class PackedNode {
+  public:
+    /// The position of the rule in the nonterminal_rules,
+    /// or NO_RULE if this is a word.
+    type_size rule = NO_RULE;
+
+    type_id left = NO_ID;
+    type_id right = NO_ID;
+  };
+
+  ParseForest() = default;
+
+  ParseForest(const ParseForest& src) = default;
+  ParseForest&
+  operator=(const ParseForest& src) = default;
+
+  ParseForest(ParseForest&& src) noexcept = default;
+  ParseForest&
+  operator=(ParseForest&& src) noexcept = default;
+
+  bool
+  empty() const {
+    return nodes_.empty();
+  }
+
+  /** The node for the whole sentence and the start rule.
+   */
+  type_id
+  root() const {
+    return 0;
+  }
+
+  const std::vector<Node>&
+  nodes() const {
+    return nodes_;
+  }
+
+  const std::vector<PackedNode>&
+  packed_nodes() const {
+    return packed_nodes_;
+  }
+
+  /** The count of different derivations of the whole sentence,
+   * without enumerating them.
+   * This is std::numeric_limits<type_count>::max() if there are more.
+   */
+  type_count
+  count_derivations() const {
+    if (empty()) {
+      return 0;
+    }
+
+    constexpr auto MAX = std::numeric_limits<type_count>::max();
+    std::vector<type_count> counts(nodes_.size(), 0);
+    for (const auto id : get_bottom_up_order()) {
+      const auto& node = nodes_[id];
+      type_count count = 0;
+      for (auto p = node.packed_begin; p < node.packed_end; ++p) {
+        const auto& packed = packed_nodes_[p];
+        type_count product = 1;
+        if (packed.rule != NO_RULE) {
+          const auto left = counts[packed.left];
+          const auto right = counts[packed.right];
+          product = (right != 0 && left > MAX / right) ? MAX : left * right;
+        }
+
+        count = (count > MAX - product) ? MAX : count + product;
+      }
+
+      counts[id] = count;
+    }
+
+    return counts[root()];
+  }
+
+  /** Choose the first packed node of each node.
+   */
+  type_choices
+  get_first_derivation() const {
+    type_choices result(nodes_.size());
+    for (type_size id = 0; id < nodes_.size(); ++id) {
+      result[id] = nodes_[id].packed_begin;
+    }
+
+    return result;
+  }
+
+  /** Choose the derivation with the smallest sum of the costs of its rules,
+   * without enumerating the other derivations.
+   *
+   * @param rule_costs The cost of each rule in the nonterminal_rules.
+   * @param cost The cost of the derivation.
+   */
+  type_choices
+  get_best_derivation(const std::vector<double>& rule_costs, double& cost) const {
+    type_choices result(nodes_.size());
+    cost = 0;
+    if (empty()) {
+      return result;
+    }
+
+    std::vector<double> costs(nodes_.size(), 0);
+    for (const auto id : get_bottom_up_order()) {
+      const auto& node = nodes_[id];
+      auto best = std::numeric_limits<double>::infinity();
+      for (auto p = node.packed_begin; p < node.packed_end; ++p) {
+        const auto& packed = packed_nodes_[p];
+        double packed_cost = 0;
+        if (packed.rule != NO_RULE) {
+          packed_cost =
+            rule_costs[packed.rule] + costs[packed.left] + costs[packed.right];
+        }
+
+        if (packed_cost < best) {
+          best = packed_cost;
+          result[id] = p;
+        }
+      }
+
+      costs[id] = best;
+    }
+
+    cost = costs[root()];
+    return result;
+  }
+
+  /** Describe the derivation, such as
+   * "(sentence ::= (noun-phrase ::= (article ::= the) (noun ::= cat)) ...)".
+   * This is only built when it is needed, for one derivation.
+   */
+  std::string
+  to_string(const CompiledGrammar& grammar, const type_choices& choices) const {
+    if (empty()) {
+      return std::string();
+    }
+
+    return to_string(grammar, choices, root());
+  }
+
+private:
+  friend class BitsetCykParser;
+
+  /** The nodes, ordered so that each node is after the nodes for the parts
+   * of its span.
+   */
+  std::vector<type_id>
+  get_bottom_up_order() const {
+    std::vector<type_id> result(nodes_.size());
+    for (type_id id = 0; id < nodes_.size(); ++id) {
+      result[id] = id;
+    }
+
+    std::stable_sort(result.begin(), result.end(), [this](type_id a, type_id b) {
+      return nodes_[a].last - nodes_[a].first < nodes_[b].last - nodes_[b].first;
+    });
+    return result;
+  }
+
+  std::string
+  to_string(const CompiledGrammar& grammar, const type_choices& choices,
+    type_id id) const {
+    const auto& node = nodes_[id];
+    const auto& packed = packed_nodes_[choices[id]];
+    const auto& name = grammar.get_nonterminal_name(node.nonterminal);
+    if (packed.rule == NO_RULE) {
+      return "(" + name + " ::= " + words_[node.first] + ")";
+    }
+
+    return "(" + name + " ::= " + to_string(grammar, choices, packed.left) +
+           " " + to_string(grammar, choices, packed.right) + ")";
+  }
+
+  std::vector<std::string> words_;
+  std::vector<Node> nodes_;
+  std::vector<PackedNode> packed_nodes_;
+};
+
+constexpr ParseForest::type_id ParseForest::NO_ID;
+constexpr ParseForest::type_size ParseForest::NO_RULE;
+
+/**
+ * Based on section 4.6 "Parsing Context-Free Grammars" from
+ * The Algorithm Design Manual by Steven S. Skiena, like
+ * DpContextFreeGrammarParser, but bottom-up (CYK), filling the spans by
+ * length.
+ *
+ * Instead of one sub-problem per span and rule name, each span has a bitset
+ * of all the nonterminals that can produce it. For each split of the span,
+ * and for each nonterminal B of the left part, we AND the right part's set
+ * with B's right set, a word at a time, and OR in the producers of each pair
+ * that is left.
+ *
+ * Reuse one parser, with one CompiledGrammar, for many sentences,
+ * so the table's memory is reused too.
+ */
+class BitsetCykParser {
+public:
+  using type_id = CompiledGrammar::type_id;
+  using type_word = CompiledGrammar::type_word;
+  using type_size = CompiledGrammar::type_size;
+
+  explicit BitsetCykParser(const CompiledGrammar& grammar)
+  : grammar_(grammar) {}
+
+  /** Whether the start rule produces the whole sentence.
+   */
+  bool
+  parse(const std::string& sentence) {
+    words_.clear();
+    sentence_words_.clear();
+    type_size start = 0;
+    const auto size = sentence.size();
+    while (start < size) {
+      // std::isspace() is undefined for negative chars, such as in UTF-8:
+      while (start < size &&
+             std::isspace(static_cast<unsigned char>(sentence[start]))) {
+        ++start;
+      }
+
+      auto end = start;
+      while (end < size &&
+             !std::isspace(static_cast<unsigned char>(sentence[end]))) {
+        ++end;
+      }
+
+      if (end > start) {
+        sentence_words_.emplace_back(sentence.substr(start, end - start));
+        words_.emplace_back(grammar_.get_terminal_id(sentence_words_.back()));
+      }
+
+      start = end;
+    }
+
+    return parse_words();
+  }
+
+  /** The count of words in the last sentence.
+   */
+  type_size
+  size() const {
+    return words_.size();
+  }
+
+  /** Whether the nonterminal produces the words [first, last) of the last
+   * sentence.
+   */
+  bool
+  can_produce(type_size first, type_size last, type_id nonterminal_id) const {
+    assert(first < last);
+    assert(last <= words_.size());
+    return CompiledGrammar::get_bit(get_set(first, last), nonterminal_id);
+  }
+
+  /** Get all the derivations of the last sentence,
+   * or an empty forest if it could not be parsed.
+   *
+   * This only creates nodes for the spans and nonterminals that are in a
+   * derivation of the whole sentence, starting from the root.
+   */
+  ParseForest
+  get_forest() const {
+    ParseForest result;
+    const auto n = words_.size();
+    if (n == 0 || !can_produce(0, n, grammar_.start_id())) {
+      return result;
+    }
+
+    result.words_ = sentence_words_;
+
+    const auto count = grammar_.nonterminals_count();
+    std::vector<type_id> node_ids((n + 1) * (n + 1) * count, ParseForest::NO_ID);
+    auto get_node_id = [&result, &node_ids, n, count](
+      type_size first, type_size last, type_id nonterminal) {
+      auto& id = node_ids[(first * (n + 1) + last) * count + nonterminal];
+      if (id == ParseForest::NO_ID) {
+        id = result.nodes_.size();
+
+        ParseForest::Node node;
+        node.first = first;
+        node.last = last;
+        node.nonterminal = nonterminal;
+        result.nodes_.emplace_back(node);
+      }
+
+      return id;
+    };
+
+    get_node_id(0, n, grammar_.start_id());
+
+    // This adds nodes to the end, for their parts, as it goes:
+    for (type_size id = 0; id < result.nodes_.size(); ++id) {
+      const auto first = result.nodes_[id].first;
+      const auto last = result.nodes_[id].last;
+      const auto nonterminal = result.nodes_[id].nonterminal;
+      const auto packed_begin = result.packed_nodes_.size();
+
+      if (last - first == 1) {
+        // Only words produce single-word spans:
+        result.packed_nodes_.emplace_back(ParseForest::PackedNode());
+      } else {
+        for (const auto& rule : grammar_.get_rules(nonterminal)) {
+          for (auto split = first + 1; split < last; ++split) {
+            if (!can_produce(first, split, rule.b) ||
+                !can_produce(split, last, rule.c)) {
+              continue;
+            }
+
+            ParseForest::PackedNode packed;
+            packed.rule = rule.index;
+            packed.left = get_node_id(first, split, rule.b);
+            packed.right = get_node_id(split, last, rule.c);
+            result.packed_nodes_.emplace_back(packed);
+          }
+        }
+      }
+
+      auto& node = result.nodes_[id];
+      node.packed_begin = packed_begin;
+      node.packed_end = result.packed_nodes_.size();
+    }
+
+    return result;
+  }
+
+private:
+  bool
+  parse_words() {
+    const auto n = words_.size();
+    if (n == 0) {
+      return false;
+    }
+
+    const auto width = grammar_.words_per_set();
+    table_.assign((n + 1) * (n + 1) * width, 0);
+
+    for (type_size i = 0; i < n; ++i) {
+      if (words_[i] == CompiledGrammar::NO_ID) {
+        continue;
+      }
+
+      const auto terminal_set = grammar_.get_terminal_set(words_[i]);
+      auto set = get_set(i, i + 1);
+      for (type_size w = 0; w < width; ++w) {
+        set[w] = terminal_set[w];
+      }
+    }
+
+    for (type_size s = 2; s <= n; ++s) {
+      for (type_size first = 0; first + s <= n; ++first) {
+        const auto last = first + s;
+        auto set = get_set(first, last);
+        for (auto split = first + 1; split < last; ++split) {
+          fill_from_split(set, get_set(first, split), get_set(split, last));
+        }
+      }
+    }
+
+    return can_produce(0, n, grammar_.start_id());
+  }
+
+  void
+  fill_from_split(
+    type_word* set, const type_word* left, const type_word* right) const {
+    const auto width = grammar_.words_per_set();
+    for (type_size lw = 0; lw < width; ++lw) {
+      for (auto lbits = left[lw]; lbits; lbits &= lbits - 1) {
+        const auto b =
+          static_cast<type_id>(lw * CompiledGrammar::BITS_PER_WORD +
+                               get_lowest_bit_index(lbits));
+        const auto right_set = grammar_.get_right_set(b);
+
+        for (type_size rw = 0; rw < width; ++rw) {
+          for (auto rbits = right[rw] & right_set[rw]; rbits;
+               rbits &= rbits - 1) {
+            const auto c =
+              static_cast<type_id>(rw * CompiledGrammar::BITS_PER_WORD +
+                                   get_lowest_bit_index(rbits));
+            const auto producer_set = grammar_.get_producer_set(b, c);
+            for (type_size w = 0; w < width; ++w) {
+              set[w] |= producer_set[w];
+            }
+          }
+        }
+      }
+    }
+  }
+
+  static type_size
+  get_lowest_bit_index(type_word bits) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(bits);
+#else
+    type_size result = 0;
+    while (!(bits & 1)) {
+      bits >>= 1;
+      ++result;
+    }
+    return result;
+#endif
+  }
+
+  type_word*
+  get_set(type_size first, type_size last) {
+    return &table_[(first * (words_.size() + 1) + last) *
+                   grammar_.words_per_set()];
+  }
+
+  const type_word*
+  get_set(type_size first, type_size last) const {
+    return &table_[(first * (words_.size() + 1) + last) *
+                   grammar_.words_per_set()];
+  }
+
+  const CompiledGrammar& grammar_;
+  std::vector<std::string> sentence_words_;
+  std::vector<type_id> words_;
+  std::vector<type_word> table_;
+};
+
+/** A simple, slow, CYK, with the count of derivations for each rule name
+ * for each span, to check BitsetCykParser and ParseForest.
+ */
+static std::vector<std::vector<std::map<std::string, ParseForest::type_count>>>
+parse_with_names(const Rules& nonterminal_rules, const Rules& terminals,
+  const std::vector<std::string>& words) {
+  const auto n = words.size();
+  std::vector<std::vector<std::map<std::string, ParseForest::type_count>>>
+    result(n + 1,
+      std::vector<std::map<std::string, ParseForest::type_count>>(n + 1));
+  for (std::size_t i = 0; i < n; ++i) {
+    for (const auto& rule : terminals) {
+      for (const auto& word : rule.second) {
+        if (word == words[i]) {
+          result[i][i + 1][rule.first] = 1;
+        }
+      }
+    }
+  }
+
+  for (std::size_t s = 2; s <= n; ++s) {
+    for (std::size_t first = 0; first + s <= n; ++first) {
+      const auto last = first + s;
+      for (auto split = first + 1; split < last; ++split) {
+        for (const auto& rule : nonterminal_rules) {
+          const auto& left = result[first][split];
+          const auto& right = result[split][last];
+          const auto iter_left = left.find(rule.second[0]);
+          const auto iter_right = right.find(rule.second[1]);
+          if (iter_left != left.end() && iter_right != right.end()) {
+            result[first][last][rule.first] +=
+              iter_left->second * iter_right->second;
+          }
+        }
+      }
+    }
+  }
+
+  return result;
+}
+
+static std::string
+join_words(const std::vector<std::string>& words) {
+  std::string result;
+  for (const auto& word : words) {
+    if (!result.empty()) {
+      result += " ";
+    }
+
+    result += word;
+  }
+
+  return result;
+}
+
+static std::vector<std::string>
+random_words(const std::vector<std::string>& vocabulary, std::size_t n,
+  std::mt19937& random) {
+  std::uniform_int_distribution<std::size_t> distribution(
+    0, vocabulary.size() - 1);
+  std::vector<std::string> result;
+  for (std::size_t i = 0; i < n; ++i) {
+    result.emplace_back(vocabulary[distribution(random)]);
+  }
+
+  return result;
+}
+
+static void
+test_against_names(const Rules& nonterminal_rules, const Rules& terminals,
+  const std::string& start_name, const std::vector<std::string>& vocabulary,
+  std::size_t max_size, std::mt19937& random) {
+  const CompiledGrammar grammar(nonterminal_rules, terminals, start_name);
+  BitsetCykParser parser(grammar);
+
+  for (std::size_t n = 1; n <= max_size; ++n) {
+    for (int attempt = 0; attempt < 20; ++attempt) {
+      const auto words = random_words(vocabulary, n, random);
+      const auto expected = parse_with_names(nonterminal_rules, terminals, words);
+      const auto parsed = parser.parse(join_words(words));
+      assert(parser.size() == n);
+      assert(parsed == (expected[0][n].count(start_name) == 1));
+
+      for (std::size_t first = 0; first < n; ++first) {
+        for (auto last = first + 1; last <= n; ++last) {
+          for (CompiledGrammar::type_id id = 0;
+               id < grammar.nonterminals_count(); ++id) {
+            const auto& name = grammar.get_nonterminal_name(id);
+            assert(parser.can_produce(first, last, id) ==
+                   (expected[first][last].count(name) == 1));
+          }
+        }
+      }
+
+      const auto forest = parser.get_forest();
+      const auto iter = expected[0][n].find(start_name);
+      assert(forest.count_derivations() ==
+             (iter == expected[0][n].end() ? 0 : iter->second));
+    }
+  }
+}
+
+int
+main() {
+  // As in the top-down DpContextFreeGrammarParser example,
+  // but with some ambiguous rules too:
+  const Rules rules_nonterminals = {{"sentence", {"noun-phrase", "verb-phrase"}},
+    {"noun-phrase", {"article", "noun"}},
+    {"noun-phrase", {"noun-phrase", "prep-phrase"}},
+    {"verb-phrase", {"verb", "noun-phrase"}},
+    {"verb-phrase", {"verb-phrase", "prep-phrase"}},
+    {"prep-phrase", {"prep", "noun-phrase"}}};
+
+  const Rules rules_terminals = {{"article", {"the", "a"}},
+    {"noun", {"cat", "milk", "dog", "garden"}}, {"verb", {"drank", "saw"}},
+    {"prep", {"in", "with"}}};
+
+  const CompiledGrammar grammar(rules_nonterminals, rules_terminals, "sentence");
+  BitsetCykParser parser(grammar);
+
+  const auto sentence = "the cat drank the milk";
+  std::cout << "String: " << sentence << std::endl;
+  const auto result = parser.parse(sentence);
+  std::cout << "result: " << (result ? "Can parse" : "Cannot parse")
+            << std::endl;
+  assert(result);
+
+  const auto verb_phrase = grammar.get_nonterminal_id("verb-phrase");
+  assert(parser.can_produce(2, 5, verb_phrase));
+  assert(!parser.can_produce(1, 5, verb_phrase));
+
+  // All the derivations, without building a solution string for every span:
+  auto forest = parser.get_forest();
+  assert(forest.count_derivations() == 1);
+  const auto solution =
+    forest.to_string(grammar, forest.get_first_derivation());
+  std::cout << "solution: " << std::endl << solution << std::endl;
+  assert(solution == "(sentence ::= (noun-phrase ::= (article ::= the) "
+                     "(noun ::= cat)) (verb-phrase ::= (verb ::= drank) "
+                     "(noun-phrase ::= (article ::= the) (noun ::= "
+                     "milk))))");
+
+  // An ambiguous sentence: Does the dog have the milk?
+  assert(parser.parse("the cat saw a dog with the milk"));
+  forest = parser.get_forest();
+  assert(forest.count_derivations() == 2);
+
+  // Prefer attaching prepositional phrases to verb phrases:
+  std::vector<double> rule_costs(rules_nonterminals.size(), 1);
+  rule_costs[2] = 10;
+  double cost = 0;
+  const auto best = forest.get_best_derivation(rule_costs, cost);
+  assert(cost == 7);
+  assert(forest.to_string(grammar, best) ==
+         "(sentence ::= (noun-phrase ::= (article ::= the) (noun ::= cat)) "
+         "(verb-phrase ::= (verb-phrase ::= (verb ::= saw) (noun-phrase ::= "
+         "(article ::= a) (noun ::= dog))) (prep-phrase ::= (prep ::= with) "
+         "(noun-phrase ::= (article ::= the) (noun ::= milk)))))");
+
+  assert(parser.parse("the cat saw a dog with the milk in the garden"));
+  assert(parser.get_forest().count_derivations() == 5);
+
+  // Far too many derivations to build them all, or even their strings,
+  // (a Catalan number) but the forest is small:
+  std::string long_sentence = "the cat saw a dog";
+  for (int i = 0; i < 15; ++i) {
+    long_sentence += " with the milk";
+  }
+
+  assert(parser.parse(long_sentence));
+  forest = parser.get_forest();
+  std::cout << "Long sentence: forest nodes: " << forest.nodes().size()
+            << ", packed nodes: " << forest.packed_nodes().size()
+            << ", derivations: " << forest.count_derivations() << std::endl;
+  assert(forest.count_derivations() == 35357670);
+
+  assert(!parser.parse("the cat drank"));
+  assert(!parser.parse("the cat drank the tea"));
+  assert(!parser.parse(""));
+  assert(parser.get_forest().empty());
+  assert(parser.get_forest().count_derivations() == 0);
+
+  // Compare with a simple parser, as a reference:
+  std::mt19937 random(1);
+  const std::vector<std::string> vocabulary = {
+    "the", "a", "cat", "milk", "dog", "drank", "saw", "in", "with", "tea"};
+  test_against_names(
+    rules_nonterminals, rules_terminals, "sentence", vocabulary, 10, random);
+
+  // A random grammar, with more nonterminals than fit in one word:
+  const std::size_t nonterminals_count = 150;
+  std::uniform_int_distribution<std::size_t> nonterminal_distribution(
+    0, nonterminals_count - 1);
+  const std::vector<std::string> random_vocabulary = {"p", "q", "r", "s"};
+  Rules random_nonterminals;
+  for (int i = 0; i < 1500; ++i) {
+    random_nonterminals.push_back(
+      {std::to_string(nonterminal_distribution(random)),
+        {std::to_string(nonterminal_distribution(random)),
+          std::to_string(nonterminal_distribution(random))}});
+  }
+
+  Rules random_terminals;
+  for (std::size_t i = 0; i < nonterminals_count; ++i) {
+    random_terminals.push_back(
+      {std::to_string(i), {random_vocabulary[i % random_vocabulary.size()]}});
+  }
+
+  test_against_names(
+    random_nonterminals, random_terminals, "0", random_vocabulary, 6, random);
+
+  // Classify a batch of sentences, changing one word in half of them:
+  const std::size_t batch_size = 20000;
+  std::vector<std::string> batch;
+  for (std::size_t i = 0; i < batch_size; ++i) {
+    auto words = random_words({"the", "a"}, 1, random);
+    for (const auto& part :
+      {random_words({"cat", "dog"}, 1, random),
+        random_words({"drank", "saw"}, 1, random), {"the"},
+        random_words({"milk", "dog"}, 1, random)}) {
+      words.insert(words.end(), part.begin(), part.end());
+    }
+
+    for (std::size_t p = 0; p < i % 4; ++p) {
+      for (const auto& part : {random_words({"in", "with"}, 1, random),
+             random_words({"the", "a"}, 1, random),
+             random_words({"garden", "cat"}, 1, random)}) {
+        words.insert(words.end(), part.begin(), part.end());
+      }
+    }
+
+    if (i % 2) {
+      words[random() % words.size()] = random_words(vocabulary, 1, random)[0];
+    }
+
+    batch.emplace_back(join_words(words));
+  }
+
+  std::cout << "Parsing " << batch_size << " sentences:" << std::endl;
+  std::size_t count_parsed = 0;
+  {
+    boost::timer::auto_cpu_timer timer;
+    for (const auto& batch_sentence : batch) {
+      if (parser.parse(batch_sentence)) {
+        ++count_parsed;
+      }
+    }
+  }
+
+  std::cout << "  parsed: " << count_parsed << std::endl;
+
+  // At least all the unchanged sentences:
+  assert(count_parsed >= batch_size / 2);
+
+  return EXIT_SUCCESS;
+}
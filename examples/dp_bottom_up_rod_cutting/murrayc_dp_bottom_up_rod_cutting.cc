@@ -14,6 +14,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/
  */
 
+#include <boost/timer/timer.hpp>
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <iomanip>
@@ -23,12 +25,13 @@
 #include <vector>
 
 #include <murraycdp/dp_bottom_up_base.h>
+#include <murraycdp/utils/semiring_matrix.h>
 
 /**
  * This is based on the Rod Cutting problem in section 15.1 of CLRS.
  */
-class DpRodCutting
-  : public murraycdp::DpBottomUpBase<
+class DpRodCutting final
+  : public murraycdp::DpBottomUp1DBase<DpRodCutting,
       0 /* (all) count of subproblems to keep, used in calc_subproblem() */,
       std::size_t, // sub problem type
       std::size_t  // i
@@ -37,12 +40,14 @@ public:
   using LengthPrices = std::vector<std::pair<std::size_t, std::size_t>>;
 
   explicit DpRodCutting(const LengthPrices& length_prices, std::size_t length)
-  : DpBottomUpBase(length + 1), // DpBottomUpBase without the
-    // specialization is apparently allowed.
+  : DpBottomUp1DBase(length + 1),
     length_prices_(length_prices),
     length_(length) {}
 
 private:
+  // DpBottomUp1DBase calls calc_subproblem() and get_goal_cell() directly:
+  friend DpBottomUp1DBase;
+
   type_subproblem
   calc_subproblem(type_base::type_level level, std::size_t i) const override {
     // Base cases:
@@ -62,7 +67,8 @@ private:
       result = length_prices_[i - 1].second;
     }
 
-    for (std::size_t j = 1; j <= i; ++j) {
+    // There are only prices for lengths up to length_prices_.size():
+    for (std::size_t j = 1; j <= i && j <= length_prices_.size(); ++j) {
       // The price when cutting one i-j piece and whatever is optimal for the
       // rest:
       const auto subproblem =
@@ -85,11 +91,39 @@ private:
   const std::size_t length_;
 };
 
+/** Get the best price for a rod of length @a length, even a huge length, with
+ * O(log(length)) max-plus matrix multiplications, instead of filling a table
+ * with length + 1 cells, as DpRodCutting does.
+ */
+static long long
+calc_price_by_recurrence(
+  const DpRodCutting::LengthPrices& length_prices, unsigned long long length) {
+  using type_semiring = murraycdp::utils::max_plus<long long>;
+
+  std::size_t max_length = 0;
+  for (const auto& length_price : length_prices) {
+    max_length = std::max(max_length, length_price.first);
+  }
+
+  // price(i) = max over j of (price of a piece of length j + price(i - j)):
+  std::vector<long long> coefficients(max_length, type_semiring::zero());
+  for (const auto& length_price : length_prices) {
+    auto& coefficient = coefficients[length_price.first - 1];
+    coefficient = std::max<long long>(coefficient, length_price.second);
+  }
+
+  const murraycdp::utils::lookback_recurrence<type_semiring> recurrence(
+    coefficients, {0});
+  return recurrence.calc(length);
+}
+
 static void
 test(const DpRodCutting::LengthPrices& length_prices, std::size_t length,
   std::size_t expected_price) {
   DpRodCutting dp(length_prices, length);
   assert(dp.calc() == expected_price);
+  assert(calc_price_by_recurrence(length_prices, length) ==
+         static_cast<long long>(expected_price));
 }
 
 int
@@ -100,5 +134,36 @@ main() {
   test(length_prices, 5, 13);
   test(length_prices, 9, 25);
 
+  // Longer than the longest priced piece:
+  for (std::size_t length = 0; length <= 100; ++length) {
+    DpRodCutting dp(length_prices, length);
+    assert(calc_price_by_recurrence(length_prices, length) ==
+           static_cast<long long>(dp.calc()));
+  }
+
+  {
+    const std::size_t length = 1000000;
+    std::size_t price = 0;
+    {
+      std::cout << "DpRodCutting, for length " << length << ":" << std::endl;
+      boost::timer::auto_cpu_timer timer;
+      DpRodCutting dp(length_prices, length);
+      price = dp.calc();
+    }
+
+    std::cout << "By max-plus matrix power:" << std::endl;
+    boost::timer::auto_cpu_timer timer;
+    assert(calc_price_by_recurrence(length_prices, length) ==
+           static_cast<long long>(price));
+  }
+
+  // Too long for any table. A piece of length 10, for 30, has the best price
+  // per length, so any multiple of 10 is worth 3 times its length:
+  const unsigned long long huge_length = 1000000000000;
+  const auto price = calc_price_by_recurrence(length_prices, huge_length);
+  std::cout << "price for length " << huge_length << ": " << price
+            << std::endl;
+  assert(price == 3000000000000);
+
   return EXIT_SUCCESS;
 }
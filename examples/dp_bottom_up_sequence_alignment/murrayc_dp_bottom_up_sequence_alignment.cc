@@ -81,18 +81,22 @@ public:
           b_count--;
           break;
         case SubSolution::cases::CASE2:
-          a = GAP_CHAR + a;
-          b = get_char_b(b_count - 1) + b;
+          a = get_char_a(a_count - 1) + a;
+          b = GAP_CHAR + b;
           a_count--;
           break;
         case SubSolution::cases::CASE3:
-          a = get_char_a(a_count - 1) + a;
-          b = GAP_CHAR;
+          a = GAP_CHAR + a;
+          b = get_char_b(b_count - 1) + b;
           b_count--;
           break;
       }
     }
 
+    // The rest of either string can only be aligned with gaps:
+    a = a_.substr(0, a_count) + get_gap(b_count) + a;
+    b = get_gap(a_count) + b_.substr(0, b_count) + b;
+
     return std::make_pair(a, b);
   }
 
@@ -103,13 +107,12 @@ private:
   static constexpr type_value MISMATCH_COST = 2;
   static constexpr char GAP_CHAR = '-';
 
+  /** The cost of pairing the last of the first @a a_count characters of a with
+   * the last of the first @a b_count characters of b.
+   */
   type_value
   match_cost(type_size a_count, type_size b_count) const {
-    if (a_count >= a_.size()) {
-      return GAP_COST;
-    } else if (b_count >= b_.size()) {
-      return GAP_COST;
-    } else if (a_[a_count] == b_[b_count]) {
+    if (a_[a_count - 1] == b_[b_count - 1]) {
       return MATCH_COST;
     } else {
       return MISMATCH_COST;
@@ -218,11 +221,9 @@ main() {
 
   // Uncomment to show the sequence: dp.print_subproblem_sequence();
 
-  assert(result.value == 16);
-  assert(solution.first == "GCC-TAGCG");
-  assert(solution.second == "GCGGCAATG"); // TODO: This doesn't seem to be
-                                          // correct. The GG isn't in the
-                                          // original string.
+  assert(result.value == 14);
+  assert(solution.first == "GCCCTAGCG");
+  assert(solution.second == "GCGC-AATG");
 
   return EXIT_SUCCESS;
 }
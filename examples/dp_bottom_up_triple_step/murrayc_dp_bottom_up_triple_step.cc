@@ -14,6 +14,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/
  */
 
+#include <boost/timer/timer.hpp>
 #include <cassert>
 #include <cstdlib>
 #include <iomanip>
@@ -22,17 +23,19 @@
 #include <string>
 #include <vector>
 
-#include <murraycdp/dp_bottom_up_base.h>
+#include <murraycdp/dp_bottom_up_stencil_base.h>
+#include <murraycdp/utils/linear_recurrence.h>
 
-class DpTripleStep
-  : public murraycdp::DpBottomUpBase<
-      4 /* count of subproblems to keep, used in calc_subproblem() */,
+class DpTripleStep final
+  : public murraycdp::DpBottomUpStencilBase<
+      murraycdp::utils::stencil<murraycdp::utils::offset<-1>,
+        murraycdp::utils::offset<-2>, murraycdp::utils::offset<-3>>,
       std::size_t, // sub problem type
       std::size_t  // i
       > {
 public:
   explicit DpTripleStep(const std::size_t steps_count)
-  : DpBottomUpBase(steps_count), // DpBottomUpBase without the
+  : DpBottomUpStencilBase(steps_count), // DpBottomUpStencilBase without the
     // specialization is apparently allowed.
     steps_count_(steps_count) {}
 
@@ -76,5 +79,33 @@ main() {
 
   assert(result == 233923);
 
+  // For i >= 3, x(i) = x(i - 1) + x(i - 2) + x(i - 3) + 6.
+  // Subtracting x(i - 1) = x(i - 2) + x(i - 3) + x(i - 4) + 6 removes the
+  // constant, so, for i >= 4, x(i) = 2 * x(i - 1) - x(i - 4),
+  // which is a linear recurrence:
+  const std::vector<long long> coefficients = {2, 0, 0, -1};
+  const std::vector<long long> initial_values = {0, 1, 4, 11};
+  const murraycdp::utils::linear_recurrence<long long> triple_step(
+    coefficients, initial_values);
+  for (std::size_t i = 1; i <= steps_count; ++i) {
+    DpTripleStep dp_i(i);
+    assert(triple_step.calc(i - 1) == static_cast<long long>(dp_i.calc()));
+  }
+
+  // Without calculating all the previous terms, modulo a prime:
+  const long long modulus = 1000000007;
+  const murraycdp::utils::linear_recurrence<long long> triple_step_modulo(
+    coefficients, initial_values, modulus);
+  const auto huge_n = 1000000000000000000ull;
+  long long huge_result = 0;
+  {
+    std::cout << "x(" << huge_n << ") modulo " << modulus << ":" << std::endl;
+    boost::timer::auto_cpu_timer timer;
+    huge_result = triple_step_modulo.calc(huge_n);
+  }
+
+  std::cout << "result: " << huge_result << std::endl;
+  assert(huge_result == 542092224);
+
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,648 @@
+/* Copyright (C) 2016 Murray Cumming
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#include <algorithm>
+#include <boost/timer/timer.hpp>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+
+typedef double type_length;
+
+const type_length LENGTH_INFINITY = std::numeric_limits<type_length>::max();
+
+class Vertex {
+public:
+  Vertex() : x(0), y(0) {}
+
+  Vertex(type_length x_in, type_length y_in) : x(x_in), y(y_in) {}
+
+  Vertex(const Vertex& src) = default;
+  Vertex&
+  operator=(const Vertex& src) = default;
+
+  Vertex(Vertex&& src) noexcept = default;
+  Vertex&
+  operator=(Vertex&& src) noexcept = default;
+
+  type_length x, y;
+};
+
+using type_vec_nodes = std::vector<Vertex>;
+using type_node_id = type_vec_nodes::size_type;
+using type_vec_node_ids = std::vector<type_node_id>;
+
+const type_node_id NODE_FIRST = 0; // 0-indexed
+
+static inline type_length
+calc_distance(const Vertex& a, const Vertex& b) {
+  return std::sqrt(std::pow(a.x - b.x, 2) + std::pow(a.y - b.y, 2));
+}
+
+/** The length of the tour, which must start at NODE_FIRST,
+ * returning to NODE_FIRST at the end.
+ */
+static type_length
+calc_tour_length(const type_vec_nodes& vertices, const type_vec_node_ids& tour) {
+  type_length result = 0;
+  for (type_vec_node_ids::size_type i = 0; i < tour.size(); ++i) {
+    const auto next = (i + 1 == tour.size()) ? tour[0] : tour[i + 1];
+    result += calc_distance(vertices[tour[i]], vertices[next]);
+  }
+
+  return result;
+}
+
+/** The distances between every pair of vertices, calculated once,
+ * stored so that the distances to each vertex are contiguous.
+ */
+class DistanceMatrix {
+public:
+  explicit DistanceMatrix(const type_vec_nodes& vertices)
+  : vertices_count_(vertices.size()),
+    distances_to_(vertices_count_ * vertices_count_) {
+    for (type_node_id to = 0; to < vertices_count_; ++to) {
+      for (type_node_id from = 0; from < vertices_count_; ++from) {
+        distances_to_[to * vertices_count_ + from] =
+          calc_distance(vertices[from], vertices[to]);
+      }
+    }
+  }
+
+  type_length
+  get(type_node_id from, type_node_id to) const {
+    return distances_to_[to * vertices_count_ + from];
+  }
+
+  /** The distances from each vertex to the vertex.
+   */
+  const type_length*
+  get_to(type_node_id to) const {
+    return &distances_to_[to * vertices_count_];
+  }
+
+private:
+  const type_node_id vertices_count_;
+  std::vector<type_length> distances_to_;
+};
+
+using type_mask = std::uint32_t;
+
+static inline type_node_id
+get_lowest_bit_index(type_mask bits) {
+#if defined(__GNUC__)
+  return __builtin_ctz(bits);
+#else
+  type_node_id result = 0;
+  while (!(bits & 1)) {
+    bits >>= 1;
+    ++result;
+  }
+  return result;
+#endif
+}
+
+/**
+ * The Held-Karp dynamic programming algorithm for the travelling salesman
+ * problem, like DpTsp, but bottom-up, with each subset of the vertices as a
+ * bitmask, instead of a std::vector of vertex ids.
+ *
+ * The table has a row for every subset of the vertices other than the start,
+ * and a column for every vertex other than the start, in one contiguous
+ * array, so it needs 2^(n-1) * (n-1) lengths. Each cell is the length of the
+ * shortest path that starts at the start, visits each vertex in the subset
+ * once, and ends at the vertex.
+ *
+ * A subset's subsets are all smaller numbers, so filling the rows in numeric
+ * order fills each row after the rows it depends on.
+ *
+ * The distances are calculated once, before filling the table, and stored
+ * so that the distances to each vertex are contiguous, because the inner
+ * loop is over the predecessors of a vertex.
+ *
+ * This takes O(2^n n^2) time and O(2^n n) memory.
+ */
+class HeldKarp {
+public:
+  static constexpr type_node_id MAX_VERTICES_COUNT =
+    std::numeric_limits<type_mask>::digits;
+
+  explicit HeldKarp(const type_vec_nodes& vertices)
+  : vertices_count_(vertices.size()), distances_(vertices) {
+    assert(vertices_count_ <= MAX_VERTICES_COUNT);
+  }
+
+  /** Get the length of the shortest tour.
+   */
+  type_length
+  calc() {
+    tour_.clear();
+    if (vertices_count_ == 0) {
+      return 0;
+    }
+
+    tour_.emplace_back(NODE_FIRST);
+    if (vertices_count_ == 1) {
+      return 0;
+    }
+
+    // Columns are the vertices other than the start: Vertex c + 1.
+    const type_node_id columns = vertices_count_ - 1;
+    const type_mask full = (type_mask(1) << columns) - 1;
+    lengths_.assign((type_node_id(full) + 1) * columns, LENGTH_INFINITY);
+
+    for (type_node_id j = 0; j < columns; ++j) {
+      lengths_[(type_node_id(1) << j) * columns + j] =
+        get_distance(NODE_FIRST, j + 1);
+    }
+
+    for (type_mask subset = 1; subset <= full; ++subset) {
+      // Subsets with only one vertex are the base cases, above:
+      if (!(subset & (subset - 1))) {
+        continue;
+      }
+
+      auto row = &lengths_[type_node_id(subset) * columns];
+      for (auto js = subset; js; js &= js - 1) {
+        const auto j = get_lowest_bit_index(js);
+        const auto subset_without_j = subset & ~(type_mask(1) << j);
+        const auto previous_row = &lengths_[type_node_id(subset_without_j) * columns];
+        const auto distances_to_j = distances_.get_to(j + 1) + 1;
+
+        auto min = LENGTH_INFINITY;
+        for (auto ks = subset_without_j; ks; ks &= ks - 1) {
+          const auto k = get_lowest_bit_index(ks);
+          const auto length = previous_row[k] + distances_to_j[k];
+          if (length < min) {
+            min = length;
+          }
+        }
+
+        row[j] = min;
+      }
+    }
+
+    // Get back to the start:
+    auto min = LENGTH_INFINITY;
+    type_node_id j_for_min = 0;
+    const auto full_row = &lengths_[type_node_id(full) * columns];
+    for (type_node_id j = 0; j < columns; ++j) {
+      const auto length = full_row[j] + get_distance(j + 1, NODE_FIRST);
+      if (length < min) {
+        min = length;
+        j_for_min = j;
+      }
+    }
+
+    build_tour(full, j_for_min);
+    return min;
+  }
+
+  /** Get the shortest tour, after calling calc(),
+   * starting with NODE_FIRST.
+   */
+  const type_vec_node_ids&
+  get_tour() const {
+    return tour_;
+  }
+
+private:
+  type_length
+  get_distance(type_node_id from, type_node_id to) const {
+    return distances_.get(from, to);
+  }
+
+  /** Walk back through the table, finding the predecessor that gave each
+   * cell's length.
+   */
+  void
+  build_tour(type_mask subset, type_node_id j) {
+    const type_node_id columns = vertices_count_ - 1;
+    type_vec_node_ids reversed;
+    while (true) {
+      reversed.emplace_back(j + 1);
+
+      const auto subset_without_j = subset & ~(type_mask(1) << j);
+      if (!subset_without_j) {
+        break;
+      }
+
+      const auto length = lengths_[type_node_id(subset) * columns + j];
+      for (auto ks = subset_without_j; ks; ks &= ks - 1) {
+        const auto k = get_lowest_bit_index(ks);
+        if (lengths_[type_node_id(subset_without_j) * columns + k] +
+              get_distance(k + 1, j + 1) ==
+            length) {
+          j = k;
+          break;
+        }
+      }
+
+      subset = subset_without_j;
+    }
+
+    tour_.insert(tour_.end(), reversed.rbegin(), reversed.rend());
+  }
+
+  const type_node_id vertices_count_;
+  const DistanceMatrix distances_;
+  std::vector<type_length> lengths_;
+  type_vec_node_ids tour_;
+};
+
+constexpr type_node_id HeldKarp::MAX_VERTICES_COUNT;
+
+/**
+ * The Held-Karp algorithm, like HeldKarp, but filling the table one layer
+ * at a time, where each layer has the subsets of one size. Each layer only
+ * depends on the previous layer, so, like DpBottomUpBase with
+ * T_COUNT_SUBPROBLEMS_TO_KEEP, we only keep two layers in memory.
+ * That's about C(n, n/2) * n lengths, instead of 2^n * n.
+ *
+ * The subsets of each size are enumerated in increasing numeric order with
+ * Gosper's hack, and each subset's row in its layer is its rank in that
+ * order. That's its combinatorial (colex) rank: The sum of C(p, i) for the
+ * i-th lowest bit, at position p.
+ *
+ * The subsets of each layer are shared between several threads.
+ *
+ * This doesn't keep enough of the table to find the tour itself,
+ * only its length.
+ */
+class LayeredHeldKarp {
+public:
+  using type_rank = std::uint64_t;
+
+  /**
+   * @param threads_count The count of threads to use for each layer,
+   * or 0 to use one thread per core.
+   */
+  explicit LayeredHeldKarp(
+    const type_vec_nodes& vertices, unsigned int threads_count = 0)
+  : vertices_count_(vertices.size()),
+    distances_(vertices),
+    threads_count_(
+      threads_count ? threads_count : std::thread::hardware_concurrency()) {
+    assert(vertices_count_ <= HeldKarp::MAX_VERTICES_COUNT);
+
+    if (threads_count_ == 0) {
+      threads_count_ = 1;
+    }
+
+    binomials_.assign(vertices_count_ + 1,
+      std::vector<type_rank>(vertices_count_ + 1, 0));
+    for (type_node_id p = 0; p <= vertices_count_; ++p) {
+      binomials_[p][0] = 1;
+      for (type_node_id i = 1; i <= p; ++i) {
+        binomials_[p][i] = binomials_[p - 1][i - 1] + binomials_[p - 1][i];
+      }
+    }
+  }
+
+  /** Get the length of the shortest tour.
+   */
+  type_length
+  calc() {
+    peak_lengths_count_ = 0;
+    if (vertices_count_ <= 1) {
+      return 0;
+    }
+
+    // Columns are the vertices other than the start: Vertex c + 1.
+    // The subsets with one vertex have ranks 0 to columns - 1.
+    const type_node_id columns = vertices_count_ - 1;
+    previous_layer_.resize(columns);
+    for (type_node_id j = 0; j < columns; ++j) {
+      previous_layer_[j] = distances_.get(NODE_FIRST, j + 1);
+    }
+
+    for (type_node_id size = 2; size <= columns; ++size) {
+      const auto count = binomials_[columns][size];
+      layer_.resize(count * size);
+      peak_lengths_count_ = std::max(
+        peak_lengths_count_, previous_layer_.size() + layer_.size());
+
+      // Don't bother with threads for small layers:
+      const type_rank min_subsets_per_thread = 4096;
+      const auto threads_count = std::max(type_rank(1),
+        std::min(type_rank(threads_count_), count / min_subsets_per_thread));
+      if (threads_count == 1) {
+        calc_layer(size, 0, count);
+      } else {
+        std::vector<std::thread> threads;
+        const auto subsets_per_thread =
+          (count + threads_count - 1) / threads_count;
+        for (type_rank first = 0; first < count; first += subsets_per_thread) {
+          const auto last = std::min(count, first + subsets_per_thread);
+          threads.emplace_back(
+            [this, size, first, last] { calc_layer(size, first, last); });
+        }
+
+        for (auto& thread : threads) {
+          thread.join();
+        }
+      }
+
+      std::swap(previous_layer_, layer_);
+    }
+
+    // Get back to the start, from the only subset with all the vertices:
+    auto min = LENGTH_INFINITY;
+    for (type_node_id j = 0; j < columns; ++j) {
+      const auto length = previous_layer_[j] + distances_.get(j + 1, NODE_FIRST);
+      if (length < min) {
+        min = length;
+      }
+    }
+
+    return min;
+  }
+
+  /** The most lengths that were in memory at once, during calc().
+   */
+  std::size_t
+  get_peak_lengths_count() const {
+    return peak_lengths_count_;
+  }
+
+private:
+  /** Fill the rows for the subsets with ranks [first, last) in the layer
+   * of subsets with @a size vertices.
+   */
+  void
+  calc_layer(type_node_id size, type_rank first, type_rank last) {
+    // Removing the i-th lowest bit, at position p, from a subset, removes
+    // C(p, i) from its rank, and changes C(q, h) to C(q, h - 1) for each
+    // higher bit, at position q, so we can get the rank of each smaller
+    // subset in O(1), with sums of those terms.
+    // higher_ranks[i] is the sum of C(q, h - 1) for the bits above the i-th.
+    type_node_id positions[HeldKarp::MAX_VERTICES_COUNT + 1];
+    type_rank higher_ranks[HeldKarp::MAX_VERTICES_COUNT + 1];
+
+    auto subset = get_subset(first, size);
+    for (auto rank = first; rank < last;
+         ++rank, subset = get_next_subset(subset)) {
+      type_node_id h = 1;
+      for (auto bits = subset; bits; bits &= bits - 1, ++h) {
+        positions[h] = get_lowest_bit_index(bits);
+      }
+
+      higher_ranks[size] = 0;
+      for (auto i = size; i > 1; --i) {
+        higher_ranks[i - 1] = higher_ranks[i] + binomials_[positions[i]][i - 1];
+      }
+
+      auto row = &layer_[rank * size];
+      type_rank lower_rank = 0;
+      type_node_id j_index = 0;
+      for (auto js = subset; js; js &= js - 1, ++j_index) {
+        const auto j = get_lowest_bit_index(js);
+        const auto subset_without_j = subset & ~(type_mask(1) << j);
+        const auto rank_without_j = lower_rank + higher_ranks[j_index + 1];
+        lower_rank += binomials_[j][j_index + 1];
+
+        const auto previous_row =
+          &previous_layer_[rank_without_j * (size - 1)];
+        const auto distances_to_j = distances_.get_to(j + 1) + 1;
+
+        // The bits are in increasing order, so the index of each k in the
+        // previous subset's row is just the count of bits so far:
+        auto min = LENGTH_INFINITY;
+        type_node_id k_index = 0;
+        for (auto ks = subset_without_j; ks; ks &= ks - 1, ++k_index) {
+          const auto k = get_lowest_bit_index(ks);
+          const auto length = previous_row[k_index] + distances_to_j[k];
+          if (length < min) {
+            min = length;
+          }
+        }
+
+        row[j_index] = min;
+      }
+    }
+  }
+
+  /** The subset with @a size vertices, with the rank.
+   */
+  type_mask
+  get_subset(type_rank rank, type_node_id size) const {
+    type_mask result = 0;
+    for (auto i = size; i > 0; --i) {
+      auto p = i - 1;
+      while (binomials_[p + 1][i] <= rank) {
+        ++p;
+      }
+
+      result |= type_mask(1) << p;
+      rank -= binomials_[p][i];
+    }
+
+    return result;
+  }
+
+  /** Gosper's hack: The next larger number with the same count of bits.
+   */
+  static type_mask
+  get_next_subset(type_mask subset) {
+    // Use 64 bits, so this can't overflow after the last subset:
+    const std::uint64_t x = subset;
+    const auto lowest = x & (~x + 1);
+    const auto ripple = x + lowest;
+    return static_cast<type_mask>((((ripple ^ x) >> 2) / lowest) | ripple);
+  }
+
+  const type_node_id vertices_count_;
+  const DistanceMatrix distances_;
+  unsigned int threads_count_;
+
+  // binomials_[p][i] is C(p, i).
+  std::vector<std::vector<type_rank>> binomials_;
+
+  std::vector<type_length> previous_layer_;
+  std::vector<type_length> layer_;
+  std::size_t peak_lengths_count_ = 0;
+};
+
+/** Compare doubles @a a and @a b to @a N_decimal_places decimal places.
+ * @tparam N_decimal_places The number of decimal places to use when comparing.
+ */
+template <std::size_t N_decimal_places>
+bool
+doubles_are_equal(double a, double b) {
+  const double multiplier = std::pow(10, N_decimal_places);
+  return std::round(a * multiplier) == std::round(b * multiplier);
+}
+
+/** Check that the tour visits every vertex once, starting at NODE_FIRST,
+ * and that it has the length.
+ */
+static bool
+tour_is_valid(const type_vec_nodes& vertices, const type_vec_node_ids& tour,
+  type_length length) {
+  if (tour.size() != vertices.size()) {
+    return false;
+  }
+
+  if (!tour.empty() && tour[0] != NODE_FIRST) {
+    return false;
+  }
+
+  auto sorted = tour;
+  std::sort(sorted.begin(), sorted.end());
+  for (type_vec_node_ids::size_type i = 0; i < sorted.size(); ++i) {
+    if (sorted[i] != i) {
+      return false;
+    }
+  }
+
+  return doubles_are_equal<9>(calc_tour_length(vertices, tour), length);
+}
+
+/** Try every tour, to check HeldKarp for small inputs.
+ */
+static type_length
+calc_with_permutations(const type_vec_nodes& vertices) {
+  if (vertices.size() <= 1) {
+    return 0;
+  }
+
+  type_vec_node_ids tour(vertices.size());
+  for (type_node_id i = 0; i < tour.size(); ++i) {
+    tour[i] = i;
+  }
+
+  auto min = LENGTH_INFINITY;
+  do {
+    min = std::min(min, calc_tour_length(vertices, tour));
+  } while (std::next_permutation(tour.begin() + 1, tour.end()));
+
+  return min;
+}
+
+static type_vec_nodes
+random_vertices(type_node_id count, std::mt19937& random) {
+  std::uniform_real_distribution<type_length> distribution(0, 1);
+  type_vec_nodes result;
+  for (type_node_id i = 0; i < count; ++i) {
+    const auto x = distribution(random);
+    const auto y = distribution(random);
+    result.emplace_back(x, y);
+  }
+
+  return result;
+}
+
+int
+main() {
+  // As in the top-down DpTsp example:
+  const type_vec_nodes vertices = {{0.328521, 0.354889}, {0.832, 0.832126},
+    {0.680803, 0.865528}, {0.734854, 0.38191}, {0.14439, 0.985427},
+    {0.90997, 0.587277}, {0.408464, 0.136019}, {0.896868, 0.916344},
+    {0.991904, 0.383134}, {0.451197, 0.741267}, {0.825205, 0.761446},
+    {0.421804, 0.0374936}, {0.332503, 0.26436}, {0.107117, 0.51559},
+    {0.845227, 0.21359}, {0.880095, 0.593086}, {0.454773, 0.834355},
+    {0.7464, 0.363176}};
+
+  std::cout << "vertices count: " << vertices.size() << std::endl;
+  HeldKarp held_karp(vertices);
+  type_length result = 0;
+  {
+    boost::timer::auto_cpu_timer timer;
+    result = held_karp.calc();
+  }
+
+  std::cout << "result: " << std::setprecision(10) << result << std::endl;
+  std::cout << "tour: ";
+  for (const auto id : held_karp.get_tour()) {
+    std::cout << id << ", ";
+  }
+  std::cout << std::endl;
+
+  assert(doubles_are_equal<5>(result, 3.50116));
+  assert(tour_is_valid(vertices, held_karp.get_tour(), result));
+
+  // Compare with trying every tour, for small inputs:
+  std::mt19937 random(1);
+  for (type_node_id count = 0; count <= 8; ++count) {
+    for (int attempt = 0; attempt < 5; ++attempt) {
+      const auto small_vertices = random_vertices(count, random);
+      HeldKarp small_held_karp(small_vertices);
+      const auto small_result = small_held_karp.calc();
+      assert(doubles_are_equal<9>(
+        small_result, calc_with_permutations(small_vertices)));
+      assert(
+        tour_is_valid(small_vertices, small_held_karp.get_tour(), small_result));
+
+      // Check the layers, with more threads than they need:
+      LayeredHeldKarp small_layered(small_vertices, 3);
+      const auto small_layered_result = small_layered.calc();
+      assert(small_layered_result == small_result);
+    }
+  }
+
+  LayeredHeldKarp layered(vertices);
+  type_length layered_result = 0;
+  {
+    boost::timer::auto_cpu_timer timer;
+    layered_result = layered.calc();
+  }
+
+  assert(layered_result == result);
+
+  // Larger inputs, which would take far too long with DpTsp.
+  // 25 vertices need 2^24 * 24 lengths (3.2 GB),
+  // and take about 20 times as long as 21 vertices.
+  const type_node_id large_count = 21;
+  const auto large_vertices = random_vertices(large_count, random);
+  std::cout << "vertices count: " << large_count << std::endl;
+  HeldKarp large_held_karp(large_vertices);
+  type_length large_result = 0;
+  {
+    boost::timer::auto_cpu_timer timer;
+    large_result = large_held_karp.calc();
+  }
+
+  std::cout << "result: " << large_result << std::endl;
+  assert(tour_is_valid(large_vertices, large_held_karp.get_tour(), large_result));
+
+  // With only two layers in memory at once.
+  // 28 vertices need about 2 * C(27, 14) * 14 lengths (4.5 GB),
+  // instead of 2^27 * 27 (29 GB).
+  LayeredHeldKarp large_layered(large_vertices);
+  std::cout << "vertices count: " << large_count
+            << ", with layers:" << std::endl;
+  type_length large_layered_result = 0;
+  {
+    boost::timer::auto_cpu_timer timer;
+    large_layered_result = large_layered.calc();
+  }
+
+  std::cout << "result: " << large_layered_result << std::endl;
+  std::cout << "peak lengths in memory: "
+            << large_layered.get_peak_lengths_count() << ", instead of: "
+            << (std::size_t(1) << (large_count - 1)) * (large_count - 1)
+            << std::endl;
+  assert(large_layered_result == large_result);
+
+  return EXIT_SUCCESS;
+}
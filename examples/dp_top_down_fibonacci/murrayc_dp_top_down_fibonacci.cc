@@ -16,14 +16,18 @@
 
 #include <boost/timer/timer.hpp>
 #include <cassert>
+#include <cstdint>
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
 #include <limits>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <murraycdp/dp_top_down_base.h>
+#include <murraycdp/utils/big_unsigned.h>
+#include <murraycdp/utils/linear_recurrence.h>
 
 /** This is the simplest example of top-down dynamic programming,
  * just to see how much boilerplate is added by the use of DpTopDownBase.
@@ -48,17 +52,25 @@
  *   return result;
  * }
  * @endcode
+ *
+ * unsigned long overflows after F(93), so use utils::big_unsigned as
+ * T_value for larger n.
  */
+template <typename T_value>
 class DpFibonacci
-  : public murraycdp::DpTopDownBase<unsigned long, // subproblem type
-      unsigned int                                 // i
+  : public murraycdp::DpTopDownBase<T_value, // subproblem type
+      unsigned int                           // i
       > {
 public:
+  using type_base = murraycdp::DpTopDownBase<T_value, unsigned int>;
+  using type_subproblem = typename type_base::type_subproblem;
+
   explicit DpFibonacci(unsigned int n) : n_(n) {}
 
 private:
   type_subproblem
-  calc_subproblem(type_base::type_level level, unsigned int i) const override {
+  calc_subproblem(
+    typename type_base::type_level level, unsigned int i) const override {
     // Base cases:
     if (i == 0) {
       return 0;
@@ -66,7 +78,8 @@ private:
       return 1;
     }
 
-    return get_subproblem(level, i - 1) + get_subproblem(level, i - 2);
+    return this->get_subproblem(level, i - 1) +
+           this->get_subproblem(level, i - 2);
   }
 
   void
@@ -78,11 +91,88 @@ private:
   const unsigned int n_;
 };
 
+/** Calculate F(n) with O(log(n)) big multiplications, instead of all the n
+ * previous terms, by "fast doubling", going from F(k - 1) and F(k) to
+ * F(2k - 1), F(2k) and F(2k + 1), for each bit of n, with just 2 squares:
+ *   F(2k - 1) = F(k)^2 + F(k - 1)^2
+ *   F(2k + 1) = 4F(k)^2 - F(k - 1)^2 + 2(-1)^k
+ *   F(2k) = F(2k + 1) - F(2k - 1)
+ *
+ * The last bit, whose step has the biggest numbers, needs only F(n), so it
+ * uses just 1 product:
+ *   F(2k) = F(k)(2F(k - 1) + F(k))
+ *   F(2k + 1) = F(k)(3F(k) + F(k - 1)) + (-1)^k
+ */
+static murraycdp::utils::big_unsigned
+calc_fibonacci_by_fast_doubling(unsigned long long n) {
+  using murraycdp::utils::big_unsigned;
+  if (n == 0) {
+    return 0;
+  }
+
+  // The bits of n after the highest one:
+  auto bit = 1ull;
+  while (bit <= n / 2) {
+    bit <<= 1;
+  }
+
+  // F(k - 1) and F(k), starting with k = 1:
+  big_unsigned previous = 0;
+  big_unsigned current = 1;
+  bool k_is_even = false;
+  for (bit >>= 1; bit > 1; bit >>= 1) {
+    const auto current_squared = current * current;
+    const auto previous_squared = previous * previous;
+    const auto f_2k_minus_1 = current_squared + previous_squared;
+
+    auto f_2k_plus_1 = current_squared + current_squared;
+    f_2k_plus_1 += f_2k_plus_1;
+    if (k_is_even) {
+      f_2k_plus_1 += 2;
+      f_2k_plus_1 -= previous_squared;
+    } else {
+      f_2k_plus_1 -= previous_squared;
+      f_2k_plus_1 -= 2;
+    }
+
+    auto f_2k = f_2k_plus_1 - f_2k_minus_1;
+    if (n & bit) {
+      // k becomes 2k + 1:
+      previous = std::move(f_2k);
+      current = std::move(f_2k_plus_1);
+      k_is_even = false;
+    } else {
+      // k becomes 2k:
+      previous = f_2k_minus_1;
+      current = std::move(f_2k);
+      k_is_even = true;
+    }
+  }
+
+  if (bit == 0) {
+    // n is 1, so there is no last step:
+    return current;
+  }
+
+  if (n & 1) {
+    auto result = current * (current + current + current + previous);
+    if (k_is_even) {
+      result += 1;
+    } else {
+      result -= 1;
+    }
+
+    return result;
+  }
+
+  return current * (previous + previous + current);
+}
+
 int
 main() {
   const auto n = 90;
 
-  DpFibonacci dp(n);
+  DpFibonacci<unsigned long> dp(n);
 
   unsigned long result = 0;
   {
@@ -95,5 +185,66 @@ main() {
 
   assert(result == 2880067194370816120ul);
 
+  // Past F(93), we need big numbers:
+  for (unsigned int i = 0; i <= 200; ++i) {
+    DpFibonacci<murraycdp::utils::big_unsigned> dp_big(i);
+    const auto big_result = dp_big.calc();
+    assert(calc_fibonacci_by_fast_doubling(i) == big_result);
+    if (i <= n) {
+      DpFibonacci<unsigned long> dp_i(i);
+      assert(big_result == dp_i.calc());
+    }
+  }
+
+  assert(calc_fibonacci_by_fast_doubling(100).to_string() ==
+         "354224848179261915075");
+
+  {
+    const unsigned int big_n = 10000;
+    murraycdp::utils::big_unsigned big_result;
+    {
+      std::cout << "fibonacci number: " << big_n << ", with DpTopDownBase:"
+                << std::endl;
+      boost::timer::auto_cpu_timer timer;
+      DpFibonacci<murraycdp::utils::big_unsigned> dp_big(big_n);
+      big_result = dp_big.calc();
+    }
+
+    std::cout << "fibonacci number: " << big_n << ", by fast doubling:"
+              << std::endl;
+    murraycdp::utils::big_unsigned doubling_result;
+    {
+      boost::timer::auto_cpu_timer timer;
+      doubling_result = calc_fibonacci_by_fast_doubling(big_n);
+    }
+
+    assert(doubling_result == big_result);
+  }
+
+  // Too big to print, but we can check its remainders:
+  const unsigned long long huge_n = 10000000;
+  murraycdp::utils::big_unsigned huge_result;
+  {
+    std::cout << "fibonacci number: " << huge_n << ", by fast doubling:"
+              << std::endl;
+    boost::timer::auto_cpu_timer timer;
+    huge_result = calc_fibonacci_by_fast_doubling(huge_n);
+  }
+
+  std::cout << "bits: " << huge_result.bit_count() << std::endl;
+
+  // Unsigned arithmetic is modulo 2^64:
+  const murraycdp::utils::linear_recurrence<unsigned long long>
+    fibonacci_low_bits({1, 1}, {0, 1});
+  assert(huge_result.get_low_bits() == fibonacci_low_bits.calc(huge_n));
+
+  const std::uint32_t modulus = 1000000007;
+  const murraycdp::utils::linear_recurrence<unsigned long long>
+    fibonacci_modulo({1, 1}, {0, 1}, modulus);
+  assert(huge_result.remainder(modulus) == fibonacci_modulo.calc(huge_n));
+
+  // F(n) is about phi^n / sqrt(5):
+  assert(huge_result.bit_count() == 6942418);
+
   return EXIT_SUCCESS;
 }
@@ -14,6 +14,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/
  */
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <iomanip>
@@ -70,6 +71,13 @@ public:
   type_vec_items solution;
 };
 
+/** For DpTopDownBase::get_subproblem_if_greater().
+ */
+inline bool
+operator<(const SubSolution& a, const SubSolution& b) {
+  return a.value < b.value;
+}
+
 class DpKnapsack
   : public murraycdp::DpTopDownBase<SubSolution,
       SubSolution::type_vec_items::size_type, Item::type_weight> {
@@ -80,9 +88,52 @@ public:
   using type_size = type_vec_items::size_type;
 
   DpKnapsack(const type_vec_items& items, type_weight weight_capacity)
-  : items_(items), weight_capacity_(weight_capacity) {}
+  : items_(items), weight_capacity_(weight_capacity) {
+    // The item indices, in order of decreasing value per weight, for
+    // get_upper_bound():
+    items_by_density_.resize(items_.size());
+    for (type_size i = 0; i < items_.size(); ++i) {
+      items_by_density_[i] = i;
+    }
+
+    std::stable_sort(std::begin(items_by_density_), std::end(items_by_density_),
+      [this](type_size a, type_size b) {
+        // a.value / a.weight > b.value / b.weight, without division:
+        return items_[a].value * items_[b].weight >
+               items_[b].value * items_[a].weight;
+      });
+  }
 
 private:
+  /** No solution with these items can have more value than the fractional
+   * knapsack solution, in which we may take part of an item.
+   * We find that greedily, taking the items with most value per weight first.
+   */
+  bool
+  get_upper_bound(type_subproblem& bound, type_size items_count,
+    type_weight weight_capacity) const override {
+    type_value value = 0;
+    auto remaining = weight_capacity;
+    for (const auto i : items_by_density_) {
+      if (i >= items_count)
+        continue;
+
+      const auto& item = items_[i];
+      if (item.weight <= remaining) {
+        value += item.value;
+        remaining -= item.weight;
+        continue;
+      }
+
+      // Part of the item, rounded up, so the bound is never too low:
+      value += (item.value * remaining + item.weight - 1) / item.weight;
+      break;
+    }
+
+    bound = type_subproblem(value);
+    return true;
+  }
+
   type_subproblem
   calc_subproblem(type_level level, type_size items_count,
     type_weight weight_capacity) const override {
@@ -98,13 +149,21 @@ private:
     // std::cout << "  calc: i=" << items_count << ", w=" << weight_capacity <<
     // std::endl;
 
-    const auto& item = items_[items_count];
+    const auto& item = items_[items_count - 1];
+
+    // Only solutions with more value than this are useful.
+    // Without a limit, any solution is better than this:
+    type_subproblem limit(-1);
+    get_limit(level, limit);
 
     // If this item's weight alone is too much,
     // try the previously-calculated lesser number of items,
     // and don't bother trying any other alternative:
     if (item.weight > weight_capacity) {
-      return get_subproblem(level, items_count - 1, weight_capacity);
+      type_subproblem result;
+      get_subproblem_if_greater(
+        level, limit, result, items_count - 1, weight_capacity);
+      return result;
     }
 
     // Case 1: This item is not in the optimal solution,
@@ -114,8 +173,11 @@ private:
     // The value for same max weight with 1 less item.
     // This recurses, so it really tells us the max possible value across all of
     // the earlier items, for the same weight capacity.
-    const auto subproblem_1_less_item =
-      get_subproblem(level, items_count - 1, weight_capacity);
+    type_subproblem subproblem_1_less_item;
+    if (!get_subproblem_if_greater(
+          level, limit, subproblem_1_less_item, items_count - 1, weight_capacity)) {
+      subproblem_1_less_item = limit;
+    }
 
     // Case 2: This item is in the optimal solution (and is the last item in
     // it),
@@ -125,17 +187,23 @@ private:
     //
     // The value for the max weight minus the current item's weight, with 1 less
     // item, plus the current item's value.
-    auto subproblem_1_less_item_less_weight =
-      get_subproblem(level, items_count - 1, weight_capacity - item.weight);
-    subproblem_1_less_item_less_weight.value += item.value;
-
-    if (subproblem_1_less_item.value >
-        subproblem_1_less_item_less_weight.value) {
+    //
+    // This is only useful if it is better than case 1, so its sub-problem
+    // can be skipped if its upper bound, plus this item's value, is not.
+    const type_subproblem limit_less_weight(
+      std::max(limit.value, subproblem_1_less_item.value) - item.value);
+    type_subproblem subproblem_1_less_item_less_weight;
+    if (!get_subproblem_if_greater(level, limit_less_weight,
+          subproblem_1_less_item_less_weight, items_count - 1,
+          weight_capacity - item.weight)) {
+      // This is no better than case 1, though that might not be better than
+      // the limit either.
       return subproblem_1_less_item;
-    } else {
-      subproblem_1_less_item_less_weight.solution.emplace_back(item);
-      return subproblem_1_less_item_less_weight;
     }
+
+    subproblem_1_less_item_less_weight.value += item.value;
+    subproblem_1_less_item_less_weight.solution.emplace_back(item);
+    return subproblem_1_less_item_less_weight;
   }
 
   void
@@ -147,6 +215,7 @@ private:
 
   const type_vec_items items_;
   const type_weight weight_capacity_;
+  std::vector<type_size> items_by_density_;
 };
 
 void
@@ -178,11 +247,15 @@ main() {
   std::cout << std::endl;
 
   std::cout << "Count of sub-problems calculated: "
+            << dp.count_calculated_sub_problems() << std::endl;
+  std::cout << "Count of sub-problems cached: "
             << dp.count_cached_sub_problems() << std::endl;
+  std::cout << "Count of sub-problems skipped by their upper bounds: "
+            << dp.count_skipped_sub_problems() << std::endl;
 
   // Uncomment to show the sequence: dp.print_subproblem_sequence();
 
-  assert(result.value == 83);
+  assert(result.value == 84);
 
   return EXIT_SUCCESS;
 }
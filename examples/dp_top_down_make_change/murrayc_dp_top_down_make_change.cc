@@ -14,11 +14,13 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/
  */
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <random>
 #include <string>
 #include <vector>
 
@@ -75,7 +77,7 @@ private:
     if (item_number < 1) {
       std::cerr << "Unexpected item_number=" << item_number << std::endl;
       return SubSolution();
-    } else if (item_number > items_.size() + 1) {
+    } else if (item_number > items_.size()) {
       std::cerr << "Unexpected item_number=" << item_number << std::endl;
       return SubSolution();
     }
@@ -152,8 +154,9 @@ private:
   void
   get_goal_cell(
     type_size& item_number, type_value& needed_value) const override {
-    // The answer is in the last-calculated cell:
-    item_number = items_.size() + 1;
+    // The answer is in the last-calculated cell.
+    // item_number is 1-indexed, so this uses all of the items:
+    item_number = items_.size();
     needed_value = needed_value_;
   }
 
@@ -175,6 +178,162 @@ private:
   const type_value needed_value_;
 };
 
+/** Shrinks a make-change problem before it is solved, and translates the
+ * smaller problem's solution back to the original coins:
+ *
+ * - Coins that are bigger than the needed value are removed.
+ * - Copies of a coin beyond the count that could fit in the needed value are
+ *   removed.
+ * - The coins and the needed value are divided by the coins' greatest common
+ *   divisor. If that does not divide the needed value, no change is possible.
+ *
+ * DpMakeChange counts every coin, so, unlike with the knapsack problem, we
+ * cannot merge identical coins, or drop a coin whose value is a multiple of
+ * another's.
+ */
+class MakeChangeReduction {
+public:
+  using type_value = SubSolution::type_value;
+  using type_vec_coins = SubSolution::type_vec_coins;
+  using type_size = SubSolution::type_size;
+
+  MakeChangeReduction(const type_vec_coins& coins, type_value needed_value)
+  : original_coins_count_(coins.size()),
+    original_needed_value_(needed_value),
+    needed_value_(needed_value),
+    divisor_(1),
+    possible_(true) {
+    // Keep the coins' order, but count how many of each we have kept so far:
+    std::vector<std::pair<type_value, type_value>> counts;
+    for (const auto coin : coins) {
+      if (coin == 0 || coin > needed_value) {
+        continue;
+      }
+
+      auto iter = std::find_if(std::begin(counts), std::end(counts),
+        [coin](const auto& count) { return count.first == coin; });
+      if (iter == std::end(counts)) {
+        counts.emplace_back(coin, 0);
+        iter = counts.end() - 1;
+      }
+
+      if (iter->second < needed_value / coin) {
+        ++(iter->second);
+        coins_.emplace_back(coin);
+      }
+    }
+
+    type_value divisor = 0;
+    for (const auto coin : coins_) {
+      divisor = calc_gcd(divisor, coin);
+    }
+
+    if (divisor > 1) {
+      if (needed_value_ % divisor != 0) {
+        possible_ = false;
+      }
+
+      divisor_ = divisor;
+      for (auto& coin : coins_) {
+        coin /= divisor;
+      }
+
+      needed_value_ /= divisor;
+    }
+  }
+
+  /** The coins of the reduced problem.
+   */
+  const type_vec_coins&
+  get_coins() const {
+    return coins_;
+  }
+
+  /** The needed value of the reduced problem.
+   */
+  type_value
+  get_needed_value() const {
+    return needed_value_;
+  }
+
+  type_value
+  get_divisor() const {
+    return divisor_;
+  }
+
+  /** Whether the reduction found that no change is possible,
+   * in which case there is no need to solve the reduced problem.
+   */
+  bool
+  is_possible() const {
+    return possible_;
+  }
+
+  /** Get the solution of the original problem from a solution of the
+   * reduced problem.
+   */
+  SubSolution
+  translate(const SubSolution& reduced) const {
+    auto result = reduced;
+    for (auto& coin : result.solution) {
+      coin *= divisor_;
+    }
+
+    return result;
+  }
+
+  /** The count of possible sub-problems for DpMakeChange with the original
+   * problem. This is a double because it can be too big for the integer
+   * types.
+   */
+  double
+  get_original_table_size() const {
+    return (original_coins_count_ + 1.0) * (original_needed_value_ + 1.0);
+  }
+
+  /** The count of possible sub-problems for DpMakeChange with the reduced
+   * problem.
+   */
+  double
+  get_table_size() const {
+    return (coins_.size() + 1.0) * (needed_value_ + 1.0);
+  }
+
+private:
+  static type_value
+  calc_gcd(type_value a, type_value b) {
+    while (b != 0) {
+      const auto remainder = a % b;
+      a = b;
+      b = remainder;
+    }
+
+    return a;
+  }
+
+  const type_size original_coins_count_;
+  const type_value original_needed_value_;
+
+  type_vec_coins coins_;
+  type_value needed_value_;
+  type_value divisor_;
+  bool possible_;
+};
+
+/** Use MakeChangeReduction, and then DpMakeChange if necessary.
+ */
+static SubSolution
+calc_reduced_make_change(
+  const SubSolution::type_vec_coins& coins, SubSolution::type_value needed_value) {
+  const MakeChangeReduction reduction(coins, needed_value);
+  if (!reduction.is_possible() || reduction.get_coins().empty()) {
+    return SubSolution(SubSolution::COIN_COUNT_INFINITY);
+  }
+
+  DpMakeChange dp(reduction.get_coins(), reduction.get_needed_value());
+  return reduction.translate(dp.calc());
+}
+
 template <typename T>
 void
 print_vec(const std::vector<T>& vec) {
@@ -241,5 +400,72 @@ std::sort(coins.begin(), coins.end(),
 
   assert(result.coin_count_used == 3);
 
+  {
+    // Amounts in cents, that are all multiples of 100:
+    const DpMakeChange::type_vec_coins cents{
+      500, 2000, 1000, 5000, 200, 1000, 10000, 100, 100, 100, 100, 100, 100};
+    const DpMakeChange::type_value needed_cents = 3700;
+
+    const MakeChangeReduction reduction(cents, needed_cents);
+    std::cout << "MakeChangeReduction: coins: " << reduction.get_coins().size()
+              << ", needed value: " << reduction.get_needed_value()
+              << ", table size: " << reduction.get_original_table_size()
+              << " reduced to " << reduction.get_table_size() << std::endl;
+    assert(reduction.get_divisor() == 100);
+    assert(reduction.get_needed_value() == 37);
+    assert(reduction.get_table_size() * 100 <
+           reduction.get_original_table_size());
+
+    const auto reduced_result = calc_reduced_make_change(cents, needed_cents);
+    assert(reduced_result.coin_count_used == 4);
+    std::cout << "with solution: ";
+    print_vec(reduced_result.solution);
+    std::cout << std::endl;
+
+    SubSolution::type_value total = 0;
+    for (const auto coin : reduced_result.solution) {
+      total += coin;
+    }
+
+    assert(total == needed_cents);
+
+    // 1 cent cannot be made from these coins:
+    const MakeChangeReduction impossible(cents, needed_cents + 1);
+    assert(!impossible.is_possible());
+  }
+
+  // Compare DpMakeChange with and without MakeChangeReduction:
+  std::mt19937 generator(1);
+  std::uniform_int_distribution<std::size_t> count_distribution(1, 12);
+  std::uniform_int_distribution<SubSolution::type_value> coin_distribution(
+    1, 20);
+  std::uniform_int_distribution<SubSolution::type_value> needed_distribution(
+    1, 100);
+  for (auto attempt = 0; attempt < 300; ++attempt) {
+    const SubSolution::type_value divisor = 1 + attempt % 3;
+    DpMakeChange::type_vec_coins random_coins;
+    const auto count = count_distribution(generator);
+    for (std::size_t i = 0; i < count; ++i) {
+      random_coins.emplace_back(coin_distribution(generator) * divisor);
+    }
+
+    const auto random_needed = needed_distribution(generator);
+
+    DpMakeChange random_dp(random_coins, random_needed);
+    const auto expected = random_dp.calc().coin_count_used;
+
+    const auto reduced_result =
+      calc_reduced_make_change(random_coins, random_needed);
+    assert(reduced_result.coin_count_used == expected);
+    if (expected != SubSolution::COIN_COUNT_INFINITY) {
+      SubSolution::type_value total = 0;
+      for (const auto coin : reduced_result.solution) {
+        total += coin;
+      }
+
+      assert(total == random_needed);
+    }
+  }
+
   return EXIT_SUCCESS;
 }
@@ -21,6 +21,7 @@
 #include <limits>
 #include <regex>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include <murraycdp/dp_top_down_base.h>
@@ -126,9 +127,14 @@ private:
     const auto X_name = produces[0];
     const auto Y_name = produces[1];
 
+    // Intern the rule names once, instead of hashing them again for each k:
+    auto key_i_to_k = intern_key(i, i, X_name);
+    auto key_k_to_j = intern_key(j, j, Y_name);
     for (uint k = i + 1; k <= j; ++k) {
-      const auto sub_i_to_k = get_subproblem(level, i, k - 1, X_name);
-      const auto sub_k_to_j = get_subproblem(level, k, j, Y_name);
+      std::get<1>(key_i_to_k) = k - 1;
+      std::get<0>(key_k_to_j) = k;
+      const auto sub_i_to_k = get_subproblem_by_key(level, key_i_to_k);
+      const auto sub_k_to_j = get_subproblem_by_key(level, key_k_to_j);
       if (sub_i_to_k.can_produce && sub_k_to_j.can_produce) {
         result.can_produce = true;
         result.solution = describe_production(nonterminal_rule_name,
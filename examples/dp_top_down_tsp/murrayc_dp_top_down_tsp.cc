@@ -76,24 +76,6 @@ get_sub_problem_base_case(
   }
 }
 
-using type_subset_id = std::string;
-
-static inline type_subset_id
-get_subset_id(const type_vec_node_ids& vertex_ids) {
-  type_subset_id result;
-  // This seems to make it slower: result.reserve(vertex_ids.size() * 2);
-  char buffer[10];
-  for (const auto& id : vertex_ids) {
-    if (!result.empty())
-      result += ",";
-
-    std::snprintf(buffer, sizeof(buffer), "%lu", id);
-    result += buffer;
-  }
-
-  return result;
-}
-
 // TODO: Avoid declaring something in std:
 namespace std {
 
@@ -101,9 +83,16 @@ template <>
 struct hash<type_vec_node_ids> {
   size_t
   operator()(const type_vec_node_ids& value) const {
-    // TODO: Performance:
-    const auto subset_id = get_subset_id(value);
-    return std::hash<type_subset_id>()(subset_id);
+    // Combine the ids' hashes, as in boost::hash_combine(),
+    // instead of building a string for every hash.
+    // DpTopDownBase only needs to hash each subset once per lookup.
+    size_t result = 0;
+    for (const auto id : value) {
+      result ^=
+        std::hash<type_node_id>()(id) + 0x9e3779b9 + (result << 6) + (result >> 2);
+    }
+
+    return result;
   }
 };
 
@@ -120,10 +109,19 @@ public:
     start_node_id_(NODE_FIRST),
     start_node_(vertices_[start_node_id_]) {
     // A vector of just the vertex IDs:
-    const auto vertices_count = vertices.size() - NODE_FIRST;
+    const auto vertices_count = vertices.size();
     vertex_ids_.resize(vertices_count);
-    for (type_node_id i = NODE_FIRST; i <= vertices_count; ++i) {
-      vertex_ids_[i - NODE_FIRST] = i;
+    for (type_node_id i = 0; i < vertices_count; ++i) {
+      vertex_ids_[i] = NODE_FIRST + i;
+    }
+
+    // The bounds need every distance many times, so we calculate them once:
+    distances_.resize(vertices_count * vertices_count);
+    for (type_node_id i = 0; i < vertices_count; ++i) {
+      for (type_node_id j = 0; j < vertices_count; ++j) {
+        distances_[i * vertices_count + j] =
+          calc_distance(vertices_[i], vertices_[j]);
+      }
     }
   }
 
@@ -134,16 +132,22 @@ public:
 
     const auto& full_subset = vertex_ids_;
 
+    // Start with the length of a (probably not optimal) greedy tour,
+    // so get_subproblem_if_less() can skip sub-problems that can only lead to
+    // longer tours.
     const int i = vertices_.size();
-    type_length min = LENGTH_INFINITY;
+    type_length min = calc_nearest_neighbour_tour_length();
     for (const auto j : vertex_ids_) {
       if (j == start_node_id_)
         continue;
 
-      const auto length = get_subproblem(level, i, full_subset, j);
-      // std::cout << "length=" << length << std::endl;
-      const auto Cj1 = calc_distance(vertices_[j], start_node_);
+      const auto Cj1 = get_distance(j, start_node_id_);
       // std::cout << "Cj1=" << Cj1 << std::endl;
+      type_length length = 0;
+      if (!get_subproblem_if_less(level, min - Cj1, length, i, full_subset, j))
+        continue;
+
+      // std::cout << "length=" << length << std::endl;
       const auto full_length = length + Cj1;
 
       // std::cout << "  : j=" << j << ", full_length=" << full_length <<
@@ -159,6 +163,78 @@ public:
 private:
   using uint = unsigned int;
 
+  type_length
+  get_distance(type_node_id a, type_node_id b) const {
+    return distances_[a * vertices_.size() + b];
+  }
+
+  type_length
+  calc_nearest_neighbour_tour_length() const {
+    std::vector<bool> visited(vertices_.size());
+    visited[start_node_id_] = true;
+    type_node_id current = start_node_id_;
+    type_length result = 0;
+    for (std::size_t step = 1; step < vertices_.size(); ++step) {
+      type_node_id nearest = current;
+      type_length nearest_length = LENGTH_INFINITY;
+      for (const auto k : vertex_ids_) {
+        if (visited[k])
+          continue;
+
+        const auto length = get_distance(current, k);
+        if (length < nearest_length) {
+          nearest = k;
+          nearest_length = length;
+        }
+      }
+
+      visited[nearest] = true;
+      result += nearest_length;
+      current = nearest;
+    }
+
+    return result + get_distance(current, start_node_id_);
+  }
+
+  /** Any path from the start to j, through all the vertices in the subset,
+   * is a spanning tree of the subset, so it is at least as long as the
+   * minimum spanning tree. We find that with Prim's algorithm.
+   */
+  bool
+  get_lower_bound(type_subproblem& bound, std::size_t /* m */,
+    const type_vec_node_ids& subset, std::size_t /* j */) const override {
+    bound = 0;
+    if (subset.empty())
+      return true;
+
+    // The shortest edge from the tree to each vertex not yet in the tree:
+    std::vector<type_length> edges(subset.size(), LENGTH_INFINITY);
+    std::vector<bool> in_tree(subset.size());
+    std::size_t added = 0;
+    for (std::size_t count = 0; count < subset.size(); ++count) {
+      in_tree[added] = true;
+      if (count > 0)
+        bound += edges[added];
+
+      std::size_t next = added;
+      type_length next_length = LENGTH_INFINITY;
+      for (std::size_t i = 0; i < subset.size(); ++i) {
+        if (in_tree[i])
+          continue;
+
+        edges[i] = std::min(edges[i], get_distance(subset[added], subset[i]));
+        if (edges[i] < next_length) {
+          next = i;
+          next_length = edges[i];
+        }
+      }
+
+      added = next;
+    }
+
+    return true;
+  }
+
   type_subproblem
   calc_subproblem(type_level level, std::size_t m,
     const type_vec_node_ids& subset, std::size_t j) const override {
@@ -170,27 +246,27 @@ private:
       std::remove(subset_without_j.begin(), subset_without_j.end(), j),
       subset_without_j.end());
 
-    type_length min = LENGTH_INFINITY;
+    // Only sub-problems that could lead to a path shorter than this are useful:
+    type_length limit = LENGTH_INFINITY;
+    get_limit(level, limit);
 
-    // std::cout << ": j=" << j << ", subset_without_j = {" <<
-    // get_subset_id(subset_without_j) << "}" << std::endl;
+    type_length min = LENGTH_INFINITY;
 
     for (const auto k : subset) {
       if (k == j)
         continue;
 
-      // std::cout << "  j= " << j << ", k=" << k << ", subset_without_j = {" <<
-      // get_subset_id(subset_without_j) << "}" << std::endl;
+      const auto Ckj = get_distance(k, j);
 
       type_length length = 0;
       if (k == start_node_id_) {
         // Base cases, for when the destination == start.
         length = get_sub_problem_base_case(subset_without_j, start_node_id_);
-      } else {
-        length = get_subproblem(level, m - 1, subset_without_j, k);
+      } else if (!get_subproblem_if_less(level, std::min(limit, min) - Ckj,
+                   length, m - 1, subset_without_j, k)) {
+        continue;
       }
 
-      const auto Ckj = calc_distance(vertices_[k], vertices_[j]);
       // std::cout << "  using A[{" << subset_without_j_id << "}, " << k << "] =
       // " << length << std::endl;
       // std::cout << "  using Ckj = " << Ckj << std::endl;
@@ -214,6 +290,7 @@ private:
 
   const type_vec_nodes vertices_;
   type_vec_node_ids vertex_ids_;
+  std::vector<type_length> distances_;
 
   const type_node_id start_node_id_;
   const Vertex& start_node_;
@@ -255,7 +332,11 @@ const type_vec_nodes vertices = {
   assert(doubles_are_equal<5>(result, 3.50116));
 
   std::cout << "Count of sub-problems calculated: "
+            << dp.count_calculated_sub_problems() << std::endl;
+  std::cout << "Count of sub-problems cached: "
             << dp.count_cached_sub_problems() << std::endl;
+  std::cout << "Count of sub-problems skipped by their lower bounds: "
+            << dp.count_skipped_sub_problems() << std::endl;
 
   return EXIT_SUCCESS;
 }
@@ -17,6 +17,7 @@
 #ifndef MURRAYCDP_DP__BASE_H
 #define MURRAYCDP_DP__BASE_H
 
+#include <cstddef>
 #include <iostream>
 #include <list>
 #include <tuple-utils/tuple_print.h>
@@ -41,7 +42,7 @@ template <typename T_subproblem, typename... T_value_types>
 class DpBase {
 public:
   using type_subproblem = T_subproblem;
-  using type_level = unsigned int;
+  using type_level = std::size_t;
   using type_values = std::tuple<typename std::decay<T_value_types>::type...>;
 
   /**
@@ -61,6 +62,21 @@ public:
   virtual type_subproblem
   calc() = 0;
 
+  /** The most sub-problem accesses that get_subproblem() keeps a record of,
+   * for print_subproblem_sequence(), so the memory used for the record does
+   * not grow with the count of sub-problems.
+   */
+  static constexpr std::size_t MAX_RECORDED_SUBPROBLEM_ACCESSES = 100000;
+
+  /** Whether get_subproblem() should keep a record of the first
+   * MAX_RECORDED_SUBPROBLEM_ACCESSES sub-problem accesses, for
+   * print_subproblem_sequence(). This is true by default.
+   */
+  void
+  set_record_subproblem_accesses(bool record) {
+    record_subproblem_accesses_ = record;
+  }
+
   void
   print_subproblem_sequence() const {
     std::size_t i = 0;
@@ -74,6 +90,11 @@ public:
       std::cout << std::endl;
       ++i;
     }
+
+    if (count_unrecorded_subproblem_accesses_ != 0) {
+      std::cout << "(and " << count_unrecorded_subproblem_accesses_
+                << " more)" << std::endl;
+    }
   }
 
 protected:
@@ -104,6 +125,8 @@ protected:
   virtual void
   clear() {
     subproblem_accesses_.clear();
+    count_unrecorded_subproblem_accesses_ = 0;
+    count_calculated_subproblems_ = 0;
   }
 
   /** Get the subproblem solution from the cache if it is in the cache,
@@ -115,8 +138,7 @@ protected:
   get_subproblem(type_level level, T_value_types... values) const {
     type_subproblem result;
     if (get_cached_subproblem(result, values...)) {
-      subproblem_accesses_.emplace_back(
-        type_values(values...), SubproblemAccess::FROM_CACHE);
+      record_subproblem_access(SubproblemAccess::FROM_CACHE, values...);
     } else {
 #if defined MURRAYC_DP_DEBUG_OUTPUT
       indent(level);
@@ -128,13 +150,47 @@ protected:
 
       set_subproblem(result, values...);
 
-      subproblem_accesses_.emplace_back(
-        type_values(values...), SubproblemAccess::CALCULATED);
+      record_subproblem_access(SubproblemAccess::CALCULATED, values...);
     }
 
     return result;
   }
 
+  enum class SubproblemAccess { CALCULATED, FROM_CACHE, SKIPPED };
+
+  /** Keep a record of the access, for print_subproblem_sequence(),
+   * if set_record_subproblem_accesses() has not turned that off,
+   * and if there are not already MAX_RECORDED_SUBPROBLEM_ACCESSES records.
+   * This counts the CALCULATED accesses even when it does not record them.
+   */
+  void
+  record_subproblem_access(
+    SubproblemAccess access, T_value_types... values) const {
+    if (access == SubproblemAccess::CALCULATED) {
+      ++count_calculated_subproblems_;
+    }
+
+    if (!record_subproblem_accesses_) {
+      return;
+    }
+
+    if (subproblem_accesses_.size() == MAX_RECORDED_SUBPROBLEM_ACCESSES) {
+      ++count_unrecorded_subproblem_accesses_;
+      return;
+    }
+
+    subproblem_accesses_.emplace_back(type_values(values...), access);
+  }
+
+  /** The count of CALCULATED accesses passed to record_subproblem_access(),
+   * such as each call to calc_subproblem() by get_subproblem(),
+   * since the last clear().
+   */
+  std::size_t
+  get_count_calculated_subproblems() const {
+    return count_calculated_subproblems_;
+  }
+
   /// Call get_goal_cell(a, b, c, d) with std::tuple<a, b, c, d>
   template <std::size_t... Is>
   void
@@ -144,8 +200,6 @@ protected:
   }
 
 private:
-  enum class SubproblemAccess { CALCULATED, FROM_CACHE };
-
   static std::string
   get_string_for_subproblem_access(SubproblemAccess enumVal) {
     switch (enumVal) {
@@ -153,6 +207,8 @@ private:
         return "calculated";
       case SubproblemAccess::FROM_CACHE:
         return "from-cache";
+      case SubproblemAccess::SKIPPED:
+        return "skipped";
       default:
         return "unknown";
     }
@@ -161,8 +217,16 @@ private:
   // Keep a record of the order in which each subproblem was calculated:
   using type_subproblem_access = std::pair<type_values, SubproblemAccess>;
   mutable std::list<type_subproblem_access> subproblem_accesses_;
+
+  mutable std::size_t count_unrecorded_subproblem_accesses_ = 0;
+  mutable std::size_t count_calculated_subproblems_ = 0;
+  bool record_subproblem_accesses_ = true;
 };
 
+template <typename T_subproblem, typename... T_value_types>
+constexpr std::size_t
+  DpBase<T_subproblem, T_value_types...>::MAX_RECORDED_SUBPROBLEM_ACCESSES;
+
 } // namespace murraycdp
 
 #endif // MURRAYCDP_DP_BOTTOM_UP_BASE_H
@@ -0,0 +1,306 @@
+/* Copyright (C) 2016 Murray Cumming
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef MURRAYCDP_DP_BEST_FIRST_BASE_H
+#define MURRAYCDP_DP_BEST_FIRST_BASE_H
+
+#include <cstddef>
+#include <experimental/tuple> //For apply().
+#include <murraycdp/utils/tuple_hash.h>
+#include <queue>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace murraycdp {
+
+/** A base class for a best-first (A*) search over the sub-problems of a
+ * dynamic programming algorithm whose solution is the cost of the cheapest
+ * path from a start cell to a goal cell, such as edit distance or sequence
+ * alignment.
+ *
+ * Where calc_subproblem() in DpBottomUpBase or DpTopDownBase gets each
+ * sub-problem from the sub-problems that it depends on, this instead treats
+ * the same dependencies as the edges of a graph, and follows them forwards,
+ * from the base case, calculating sub-problems in order of their cost plus
+ * a heuristic estimate of the remaining cost to the goal.
+ * It stops when the goal cell is reached, so, when the heuristic is good,
+ * most of the sub-problems are never calculated.
+ *
+ * Derive from this class, implementing get_start_cell(), get_goal_cell(),
+ * and expand(), and, ideally, get_heuristic().
+ * Then call calc() to get the overall solution.
+ *
+ * Nothing here checks expand() against calc_subproblem()'s dependencies.
+ * Where those are a utils::stencil, derive from DpBestFirstStencilBase
+ * instead, which implements expand() from the stencil.
+ *
+ * @tparam T_cost The type of the path costs, such as unsigned int.
+ * @tparam T_value_types The types of the values that identify each
+ * sub-problem, such as the i and j indices of a table cell.
+ */
+template <typename T_cost, typename... T_value_types>
+class DpBestFirstBase {
+public:
+  using type_cost = T_cost;
+  using type_values = std::tuple<typename std::decay<T_value_types>::type...>;
+
+  DpBestFirstBase() {}
+
+  DpBestFirstBase(const DpBestFirstBase& src) = delete;
+  DpBestFirstBase&
+  operator=(const DpBestFirstBase& src) = delete;
+
+  DpBestFirstBase(DpBestFirstBase&& src) noexcept = delete;
+  DpBestFirstBase&
+  operator=(DpBestFirstBase&& src) noexcept = delete;
+
+  /** Get the cost of the cheapest path from the start cell to the goal cell.
+   *
+   * @result The cost, or a default-constructed type_cost if the goal cannot be
+   * reached. See goal_is_reached().
+   */
+  type_cost
+  calc() {
+    clear();
+
+    type_values start;
+    get_start_cell_call_with_tuple(
+      start, std::index_sequence_for<T_value_types...>());
+    get_goal_cell_call_with_tuple(
+      goal_, std::index_sequence_for<T_value_types...>());
+
+    current_ = nullptr;
+    current_cost_ = type_cost();
+    add_successor_with_tuple(type_cost(), start);
+
+    while (!queue_.empty()) {
+      const auto entry = queue_.top();
+      queue_.pop();
+
+      // Ignore entries for states that have since been reached more cheaply:
+      const auto& state = states_.at(*entry.values);
+      if (state.cost < entry.cost) {
+        continue;
+      }
+
+      // With an admissible heuristic, the first time that we take the goal
+      // from the queue, there can be no cheaper path to it.
+      if (*entry.values == goal_) {
+        goal_state_ = &state;
+        return state.cost;
+      }
+
+      ++count_expanded_;
+      current_ = entry.values;
+      current_cost_ = entry.cost;
+      std::experimental::apply(
+        [this](T_value_types... the_values) { this->expand(the_values...); },
+        *entry.values);
+    }
+
+    return type_cost();
+  }
+
+  /** Whether the last calc() found a path to the goal cell.
+   */
+  bool
+  goal_is_reached() const {
+    return goal_state_ != nullptr;
+  }
+
+  /** The cells on the cheapest path found by the last calc(),
+   * from the start cell to the goal cell.
+   */
+  std::vector<type_values>
+  get_path() const {
+    std::vector<type_values> result;
+    if (!goal_state_) {
+      return result;
+    }
+
+    const type_values* values = &goal_;
+    while (values) {
+      result.emplace_back(*values);
+      values = states_.at(*values).previous;
+    }
+
+    return std::vector<type_values>(result.rbegin(), result.rend());
+  }
+
+  /** The count of sub-problems that were expanded by the last calc().
+   * Compare this to the size of the whole table, for instance, which a
+   * DpBottomUpBase would fill.
+   */
+  std::size_t
+  count_expanded_states() const {
+    return count_expanded_;
+  }
+
+  /** The count of sub-problems whose cost was calculated by the last calc(),
+   * including those that were reached but not expanded.
+   */
+  std::size_t
+  count_reached_states() const {
+    return states_.size();
+  }
+
+protected:
+  /** Get the cell of the base case, whose cost is 0.
+   */
+  virtual void
+  get_start_cell(typename std::decay<T_value_types>::type&... values) const = 0;
+
+  /** Get the cell whose cost is the solution.
+   */
+  virtual void
+  get_goal_cell(typename std::decay<T_value_types>::type&... values) const = 0;
+
+  /** Call add_successor() for each sub-problem whose calc_subproblem()
+   * would use this sub-problem, with the cost that it would add.
+   * The costs must not be negative.
+   */
+  virtual void
+  expand(T_value_types... values) const = 0;
+
+  /** Estimate the remaining cost from this cell to the goal cell.
+   * This must never be more than the real remaining cost (it must be
+   * admissible), or calc() might not find the cheapest path.
+   * The default, 0, makes calc() a plain Dijkstra search.
+   */
+  virtual type_cost
+  get_heuristic(T_value_types... /* values */) const {
+    return type_cost();
+  }
+
+  /** Call this from expand().
+   * @param edge_cost The cost of going from the sub-problem being expanded to
+   * this sub-problem.
+   */
+  void
+  add_successor(const type_cost& edge_cost, T_value_types... values) const {
+    add_successor_with_tuple(edge_cost, type_values(values...));
+  }
+
+  virtual void
+  clear() {
+    states_.clear();
+    queue_ = type_queue();
+    current_ = nullptr;
+    goal_state_ = nullptr;
+    count_expanded_ = 0;
+  }
+
+private:
+  class State {
+  public:
+    type_cost cost;
+
+    // The previous cell on the cheapest path to this one, if any.
+    // Keys of an unordered_map are not moved when it is rehashed,
+    // so we can point to them.
+    const type_values* previous;
+  };
+
+  class QueueEntry {
+  public:
+    type_cost estimate; // cost + heuristic.
+    type_cost cost;
+    const type_values* values;
+  };
+
+  class QueueEntryCompare {
+  public:
+    bool
+    operator()(const QueueEntry& a, const QueueEntry& b) const {
+      // std::priority_queue<> takes the greatest first,
+      // so this puts the lowest estimate first.
+      // Between equal estimates, we take the most costly, because that is
+      // nearer to the goal.
+      if (b.estimate < a.estimate) {
+        return true;
+      }
+
+      if (a.estimate < b.estimate) {
+        return false;
+      }
+
+      return a.cost < b.cost;
+    }
+  };
+
+  void
+  add_successor_with_tuple(
+    const type_cost& edge_cost, const type_values& values) const {
+    const type_cost cost = current_cost_ + edge_cost;
+    const auto inserted = states_.emplace(values, State{cost, current_});
+    auto& state = inserted.first->second;
+    if (!inserted.second) {
+      if (!(cost < state.cost)) {
+        return;
+      }
+
+      state.cost = cost;
+      state.previous = current_;
+    }
+
+    const type_values* key = &(inserted.first->first);
+    const auto heuristic = std::experimental::apply(
+      [this](T_value_types... the_values) {
+        return this->get_heuristic(the_values...);
+      },
+      values);
+    queue_.push(QueueEntry{cost + heuristic, cost, key});
+  }
+
+  /// Call get_start_cell(a, b, c, d) with std::tuple<a, b, c, d>
+  template <std::size_t... Is>
+  void
+  get_start_cell_call_with_tuple(
+    type_values& values, std::index_sequence<Is...>) const {
+    get_start_cell(std::get<Is>(values)...);
+  }
+
+  /// Call get_goal_cell(a, b, c, d) with std::tuple<a, b, c, d>
+  template <std::size_t... Is>
+  void
+  get_goal_cell_call_with_tuple(
+    type_values& values, std::index_sequence<Is...>) const {
+    get_goal_cell(std::get<Is>(values)...);
+  }
+
+  using type_map_states =
+    std::unordered_map<type_values, State, utils::hash_tuple::hash<type_values>>;
+  mutable type_map_states states_;
+
+  using type_queue =
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, QueueEntryCompare>;
+  mutable type_queue queue_;
+
+  // The sub-problem being expanded:
+  mutable const type_values* current_ = nullptr;
+  mutable type_cost current_cost_ = type_cost();
+
+  type_values goal_;
+  const State* goal_state_ = nullptr;
+  std::size_t count_expanded_ = 0;
+};
+
+} // namespace murraycdp
+
+#endif // MURRAYCDP_DP_BEST_FIRST_BASE_H
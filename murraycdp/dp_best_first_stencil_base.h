@@ -0,0 +1,146 @@
+/* Copyright (C) 2016 Murray Cumming
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef MURRAYCDP_DP_BEST_FIRST_STENCIL_BASE_H
+#define MURRAYCDP_DP_BEST_FIRST_STENCIL_BASE_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <murraycdp/dp_best_first_base.h>
+#include <murraycdp/utils/stencil.h>
+
+namespace murraycdp {
+
+/** A DpBestFirstBase whose successors come from the same utils::stencil that
+ * a DpBottomUpStencilBase declares for its calc_subproblem(), instead of from
+ * a hand-written expand().
+ *
+ * Sub-problem x depends on x + offset, for each of the stencil's offsets, so
+ * the successors of sub-problem y are y - offset. This implements expand() by
+ * following each offset backwards, skipping the cells outside the box between
+ * the start cell and the goal cell, and asking get_edge_cost() for the cost
+ * that each successor's calc_subproblem() would add.
+ *
+ * So a DpBottomUpStencilBase that uses the same stencil, and whose
+ * get_subproblem() asserts that each access is one of the stencil's, checks
+ * the dependencies that this follows.
+ *
+ * @tparam T_stencil A utils::stencil<> with the same count of dimensions as
+ * T_value_types, which must be integral.
+ */
+template <typename T_stencil, typename T_cost, typename... T_value_types>
+class DpBestFirstStencilBase
+  : public DpBestFirstBase<T_cost, T_value_types...> {
+public:
+  static_assert(T_stencil::COUNT_DIMENSIONS == sizeof...(T_value_types),
+    "The stencil needs an offset for each of the values.");
+
+  using type_base = DpBestFirstBase<T_cost, T_value_types...>;
+  using type_cost = typename type_base::type_cost;
+  using type_values = typename type_base::type_values;
+  using type_stencil = T_stencil;
+  using type_offsets = typename T_stencil::type_offsets;
+
+protected:
+  /** Get the cost that calc_subproblem() for the sub-problem at @a values
+   * would add to the sub-problem at @a values + @a offsets.
+   * The costs must not be negative.
+   */
+  virtual type_cost
+  get_edge_cost(const type_offsets& offsets, T_value_types... values) const = 0;
+
+  void
+  clear() override {
+    type_base::clear();
+
+    type_values start, goal;
+    get_start_cell_call_with_tuple(
+      start, std::index_sequence_for<T_value_types...>());
+    get_goal_cell_call_with_tuple(
+      goal, std::index_sequence_for<T_value_types...>());
+    set_bounds(start, goal, std::index_sequence_for<T_value_types...>());
+  }
+
+private:
+  void
+  expand(T_value_types... values) const final {
+    const type_values current(values...);
+    for (const auto& offsets : T_stencil::get_offsets()) {
+      add_successor_for_offsets(
+        current, offsets, std::index_sequence_for<T_value_types...>());
+    }
+  }
+
+  template <std::size_t... Is>
+  void
+  add_successor_for_offsets(const type_values& current,
+    const type_offsets& offsets, std::index_sequence<Is...>) const {
+    const type_bounds successor{
+      {static_cast<std::ptrdiff_t>(std::get<Is>(current)) - offsets[Is]...}};
+    for (std::size_t i = 0; i < successor.size(); ++i) {
+      if (successor[i] < lower_[i] || successor[i] > upper_[i]) {
+        return;
+      }
+    }
+
+    const auto edge_cost = get_edge_cost(offsets,
+      static_cast<typename std::tuple_element<Is, type_values>::type>(
+        successor[Is])...);
+    this->add_successor(edge_cost,
+      static_cast<typename std::tuple_element<Is, type_values>::type>(
+        successor[Is])...);
+  }
+
+  template <std::size_t... Is>
+  void
+  set_bounds(const type_values& start, const type_values& goal,
+    std::index_sequence<Is...>) {
+    lower_ = type_bounds{{static_cast<std::ptrdiff_t>(
+      std::min(std::get<Is>(start), std::get<Is>(goal)))...}};
+    upper_ = type_bounds{{static_cast<std::ptrdiff_t>(
+      std::max(std::get<Is>(start), std::get<Is>(goal)))...}};
+  }
+
+  /// Call get_start_cell(a, b, c, d) with std::tuple<a, b, c, d>
+  template <std::size_t... Is>
+  void
+  get_start_cell_call_with_tuple(
+    type_values& values, std::index_sequence<Is...>) const {
+    this->get_start_cell(std::get<Is>(values)...);
+  }
+
+  /// Call get_goal_cell(a, b, c, d) with std::tuple<a, b, c, d>
+  template <std::size_t... Is>
+  void
+  get_goal_cell_call_with_tuple(
+    type_values& values, std::index_sequence<Is...>) const {
+    this->get_goal_cell(std::get<Is>(values)...);
+  }
+
+  // The box between the start cell and the goal cell:
+  using type_bounds = std::array<std::ptrdiff_t, sizeof...(T_value_types)>;
+  type_bounds lower_ = type_bounds();
+  type_bounds upper_ = type_bounds();
+};
+
+} // namespace murraycdp
+
+#endif // MURRAYCDP_DP_BEST_FIRST_STENCIL_BASE_H
@@ -17,17 +17,23 @@
 #ifndef MURRAYCDP_DP_BOTTOM_UP_BASE_H
 #define MURRAYCDP_DP_BOTTOM_UP_BASE_H
 
+#include <algorithm>
+#include <array>
+#include <cassert>
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
 #include <limits>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <experimental/tuple> //For apply().
 
 #include <murraycdp/dp_base.h>
 #include <murraycdp/utils/circular_vector.h>
+#include <murraycdp/utils/ring_buffer.h>
 #include <murraycdp/utils/vector_of_vectors.h>
 #include <tuple-utils/tuple_cdr.h>
 #include <tuple-utils/tuple_interlace.h>
@@ -50,7 +56,7 @@ namespace murraycdp {
  * @tparam T_value_types The types of the parameters for the calc_subproblem()
  * method.
  */
-template <unsigned int T_COUNT_SUBPROBLEMS_TO_KEEP, typename T_subproblem,
+template <std::size_t T_COUNT_SUBPROBLEMS_TO_KEEP, typename T_subproblem,
   typename... T_value_types>
 class DpBottomUpBase : public DpBase<T_subproblem, T_value_types...> {
 public:
@@ -67,15 +73,11 @@ public:
    * @pram The number of j values to calculate the subproblem for.
    */
   DpBottomUpBase(typename std::decay<T_value_types>::type... value_counts)
-  : subproblems_(T_COUNT_SUBPROBLEMS_TO_KEEP == 0 ? std::get<0>(std::make_tuple(value_counts...)) : T_COUNT_SUBPROBLEMS_TO_KEEP),
+  : subproblems_(create_subproblems(
+      std::get<0>(std::make_tuple(value_counts...)),
+      std::integral_constant<bool, T_COUNT_SUBPROBLEMS_TO_KEEP == 0>())),
     value_counts_(value_counts...) {
-    const auto value_counts_without_i = tupleutils::tuple_cdr(value_counts_);
-    constexpr auto tuple_size =
-      std::tuple_size<decltype(value_counts_without_i)>::value;
-    if (tuple_size > 0) {
-      call_resize_sub_vectors_with_tuple(
-        value_counts_without_i, std::make_index_sequence<tuple_size>());
-    }
+    reset_subproblems();
   }
 
   DpBottomUpBase(const DpBottomUpBase& src) = delete;
@@ -88,61 +90,45 @@ public:
 
   type_subproblem
   calc() override {
-    subproblems_.clear();
+    reset_subproblems();
 
     type_level level = 0; // unused
 
-    // For some reason this always sets depth to 1:
-    // const bool depth = sizeof...(T_value_types);
-    // so we use std::tuple_size() instead.
-    constexpr auto depth =
-      std::tuple_size<type_values>::value; // sizeof...(T_value_types);
-    // std::cout << "debug: depth=" << depth << std::endl;
-
     const auto i_count = std::get<0>(value_counts_);
-    for (unsigned int i = 0; i < i_count; ++i) {
+    for (std::decay_t<decltype(i_count)> i = 0; i < i_count; ++i) {
+      // The previous subproblems_i will then be read as subproblems_i_minus_1;
+      // and the oldest will be filled as subproblems_i.
+      // We don't step after the last i, so its subproblems are still
+      // available with only 1 subproblem to keep.
+      if (i != 0) {
+        subproblems_.step();
+      }
+
 #if defined(MURRAYC_DP_DEBUG_OUTPUT)
       std::cout << "i=" << std::setw(2) << i << ": ";
 #endif
-      if (depth == 1) {
-        // Call it via a tuple,
-        // to avoid a compilation error when depth is not 1:
-        type_values values;
-        std::get<0>(values) = i;
-
-        const auto subproblem = std::experimental::apply(
-          [this, level](T_value_types... the_values) {
-            return this->calc_subproblem(level, the_values...);
-          },
-          values);
-
-        std::experimental::apply(
-          [this, subproblem](T_value_types... the_values) {
-            return this->set_subproblem(subproblem, the_values...);
-          },
-          values);
-      } else {
-        type_subproblems& subproblems_i =
-          subproblems_.get_at_offset_from_start(i);
-
-        using type_values_counts_without_i =
-          typename tupleutils::tuple_type_cdr<type_values>::type;
-        // TODO: Why can't this be const when it is tuple<> (with no element
-        // types):
-        type_values_counts_without_i
-          values_starts_without_i; // TODO: explicitly initialize to 0.
-        const auto value_counts_without_i = tupleutils::tuple_cdr(value_counts_);
-
-        const auto values_start_end = tupleutils::tuple_interlace(
-          values_starts_without_i, value_counts_without_i);
-
-        constexpr std::size_t values_start_end_size =
-          std::tuple_size<decltype(values_start_end)>::value;
-
-        call_for_sub_vectors_with_tuple(subproblems_i,
-          [this, level, i](auto... params) {
-            const auto subproblem = this->calc_subproblem(level, i, params...);
-            this->set_subproblem(subproblem, i, params...);
+      type_subproblems& subproblems_i =
+        subproblems_.get_at_offset_from_start(i);
+
+      using type_values_counts_without_i =
+        typename tupleutils::tuple_type_cdr<type_values>::type;
+      // TODO: Why can't this be const when it is tuple<> (with no element
+      // types):
+      type_values_counts_without_i
+        values_starts_without_i; // TODO: explicitly initialize to 0.
+      const auto value_counts_without_i = tupleutils::tuple_cdr(value_counts_);
+
+      const auto values_start_end = tupleutils::tuple_interlace(
+        values_starts_without_i, value_counts_without_i);
+
+      constexpr std::size_t values_start_end_size =
+        std::tuple_size<decltype(values_start_end)>::value;
+
+      call_for_sub_vectors_with_tuple(subproblems_i,
+        [this, level, i](auto... params) {
+          this->current_cell_ = type_values(i, params...);
+          const auto subproblem = this->calc_subproblem(level, i, params...);
+          this->set_subproblem(subproblem, i, params...);
 
 #if defined(MURRAYC_DP_DEBUG_OUTPUT)
 // if (j != 0) {
@@ -150,17 +136,12 @@ public:
 //}
 // std::cout << std::setw(2) << subproblem.cost;
 #endif
-          },
-          values_start_end, std::make_index_sequence<values_start_end_size>());
+        },
+        values_start_end, std::make_index_sequence<values_start_end_size>());
 
 #if defined(MURRAYC_DP_DEBUG_OUTPUT)
-        std::cout << std::endl;
+      std::cout << std::endl;
 #endif
-      }
-
-      // subproblems_i will then be read as subproblems_i_minus_1;
-      // and subproblems_i_minus_1 will be filled as subproblems_i;
-      subproblems_.step();
     }
 
     // We cannot do this to pass the output parameters to get_goal_cell():
@@ -264,9 +245,271 @@ private:
   }
 
 protected:
-  using type_vec_subproblems = utils::circular_vector<type_subproblems>;
+  /** The sub-problem that calc() is now calculating.
+   */
+  const type_values&
+  get_current_cell() const {
+    return current_cell_;
+  }
+
+  /** Clear the subproblems left by any previous calc(),
+   * and size them for the values other than i.
+   */
+  void
+  reset_subproblems() {
+    type_base::clear();
+    subproblems_.clear();
+
+    const auto value_counts_without_i = tupleutils::tuple_cdr(value_counts_);
+    constexpr auto tuple_size =
+      std::tuple_size<decltype(value_counts_without_i)>::value;
+    if (tuple_size > 0) {
+      call_resize_sub_vectors_with_tuple(
+        value_counts_without_i, std::make_index_sequence<tuple_size>());
+    }
+  }
+
+  /** All the subproblems, in a circular_vector whose size is the count of i
+   * values, if we keep them all, or otherwise just the rows that we keep, in
+   * a ring_buffer, whose positions are calculated more cheaply.
+   */
+  using type_vec_subproblems =
+    typename std::conditional<T_COUNT_SUBPROBLEMS_TO_KEEP == 0,
+      utils::circular_vector<type_subproblems>,
+      utils::ring_buffer<type_subproblems, T_COUNT_SUBPROBLEMS_TO_KEEP>>::type;
+
+private:
+  template <typename T_i_count>
+  static type_vec_subproblems
+  create_subproblems(T_i_count i_count, std::true_type /* keep all */) {
+    return type_vec_subproblems(i_count);
+  }
+
+  template <typename T_i_count>
+  static type_vec_subproblems
+  create_subproblems(T_i_count /* i_count */, std::false_type /* keep all */) {
+    return type_vec_subproblems();
+  }
+
+protected:
   mutable type_vec_subproblems subproblems_;
   const type_values value_counts_;
+
+private:
+  type_values current_cell_;
+};
+
+/** A base class for a 1D bottom-up dynamic programming algorithm, such as
+ * fibonacci, whose calc() calls the derived class's calc_subproblem()
+ * directly, instead of via a virtual call.
+ *
+ * The derived class passes itself as T_derived, and must let this class call
+ * its calc_subproblem() and get_goal_cell(), for instance by declaring it as a
+ * friend:
+ * @code
+ * class DpFibonacci final
+ *   : public murraycdp::DpBottomUp1DBase<DpFibonacci, 2, unsigned long,
+ *       unsigned int> {
+ *   friend DpBottomUp1DBase;
+ *   ...
+ * @endcode
+ * So the compiler can inline calc_subproblem() into calc(), with no check of
+ * the vtable for each i, and keep the window in registers.
+ *
+ * This keeps the last T_COUNT_SUBPROBLEMS_TO_KEEP sub-problems in a
+ * std::array, shifting them along after each i, instead of using a
+ * utils::ring_buffer, and its get_subproblem() reads them directly,
+ * without DpBase::get_subproblem()'s virtual calls. It still keeps DpBase's
+ * record of the accesses, for print_subproblem_sequence(), unless the derived
+ * class passes false as T_RECORD_SUBPROBLEM_ACCESSES. Then, for fibonacci,
+ * GCC 12 at -O2 compiles calc()'s main loop to the same instructions as a
+ * hand-written loop. set_record_subproblem_accesses(false) is not enough for
+ * that, because the loop would still check it for each access.
+ *
+ * With a T_COUNT_SUBPROBLEMS_TO_KEEP of 0, it keeps all the sub-problems in a
+ * std::vector.
+ *
+ * In debug builds, get_subproblem() asserts that the sub-problem is still in
+ * the window.
+ *
+ * @tparam T_RECORD_SUBPROBLEM_ACCESSES Whether get_subproblem() keeps a record
+ * of each access, for print_subproblem_sequence(), as long as
+ * set_record_subproblem_accesses() has not turned that off.
+ */
+template <typename T_derived, std::size_t T_COUNT_SUBPROBLEMS_TO_KEEP,
+  typename T_subproblem, typename T_value_type,
+  bool T_RECORD_SUBPROBLEM_ACCESSES = true>
+class DpBottomUp1DBase : public DpBase<T_subproblem, T_value_type> {
+public:
+  using type_base = DpBase<T_subproblem, T_value_type>;
+  using type_subproblem = T_subproblem;
+  using type_values = typename type_base::type_values;
+  using type_level = typename type_base::type_level;
+  using type_value = typename std::decay<T_value_type>::type;
+
+  /**
+   * @param i_count The number of i values to calculate the subproblem for.
+   */
+  explicit DpBottomUp1DBase(type_value i_count) : i_count_(i_count) {}
+
+  DpBottomUp1DBase(const DpBottomUp1DBase& src) = delete;
+  DpBottomUp1DBase&
+  operator=(const DpBottomUp1DBase& src) = delete;
+
+  DpBottomUp1DBase(DpBottomUp1DBase&& src) noexcept = delete;
+  DpBottomUp1DBase&
+  operator=(DpBottomUp1DBase&& src) noexcept = delete;
+
+  type_subproblem
+  calc() override {
+    type_base::clear();
+    if (KEEP_ALL) {
+      all_.assign(i_count_, type_subproblem());
+    } else {
+      window_.fill(type_subproblem());
+    }
+
+    const auto& derived = static_cast<const T_derived&>(*this);
+    const type_level level = 0; // unused
+
+    // The first sub-problems are usually the base cases, because there are
+    // not yet enough previous sub-problems, so we calculate them in a
+    // separate loop. Then the compiler knows that i is past them in the main
+    // loop, and can remove calc_subproblem()'s checks for them, which would
+    // otherwise be in the loop's dependency chain.
+    const type_value first_count =
+      std::min<type_value>(i_count_, WINDOW_SIZE);
+    for (type_value i = 0; i < first_count; ++i) {
+      current_i_ = i;
+      store_next(derived.calc_subproblem(level, i));
+    }
+
+    for (type_value i = WINDOW_SIZE; i < i_count_; ++i) {
+      current_i_ = i;
+      store_next(derived.calc_subproblem(level, i));
+    }
+
+    current_i_ = i_count_;
+
+    type_value goal = 0;
+    derived.get_goal_cell(goal);
+    return get_subproblem(level, goal);
+  }
+
+protected:
+  /** Get a sub-problem that calc() has already calculated.
+   * This hides DpBase::get_subproblem().
+   */
+  const type_subproblem&
+  get_subproblem(type_level /* level */, type_value i) const {
+    assert(i < current_i_);
+
+    if (T_RECORD_SUBPROBLEM_ACCESSES) {
+      this->record_subproblem_access(
+        type_base::SubproblemAccess::FROM_CACHE, i);
+    }
+
+    if (KEEP_ALL) {
+      return all_[i];
+    }
+
+    // Otherwise the sub-problem has already been discarded:
+    assert(current_i_ - i <= WINDOW_SIZE);
+    return window_[WINDOW_SIZE - (current_i_ - i)];
+  }
+
+  /** The sub-problem that calc() is now calculating.
+   */
+  type_values
+  get_current_cell() const {
+    return type_values(current_i_);
+  }
+
+private:
+  static constexpr bool KEEP_ALL = (T_COUNT_SUBPROBLEMS_TO_KEEP == 0);
+
+  // std::array<> cannot be empty, so a window of size 1 is unused when
+  // keeping all sub-problems:
+  static constexpr std::size_t WINDOW_SIZE =
+    KEEP_ALL ? 1 : T_COUNT_SUBPROBLEMS_TO_KEEP;
+
+  void
+  store_next(const type_subproblem& subproblem) {
+    if (KEEP_ALL) {
+      all_[current_i_] = subproblem;
+      return;
+    }
+
+    // The oldest sub-problem is first, and the newest is last:
+    for (std::size_t k = 0; k + 1 < WINDOW_SIZE; ++k) {
+      window_[k] = std::move(window_[k + 1]);
+    }
+
+    window_[WINDOW_SIZE - 1] = subproblem;
+  }
+
+  bool
+  get_cached_subproblem(
+    type_subproblem& subproblem, T_value_type i) const override {
+    if (i >= current_i_ ||
+        (!KEEP_ALL && current_i_ - i > WINDOW_SIZE)) {
+      return false;
+    }
+
+    subproblem = get_subproblem(0, i);
+    return true;
+  }
+
+  void
+  set_subproblem(
+    const type_subproblem& /* subproblem */, T_value_type /* i */) const override {
+    // calc() stores each sub-problem itself,
+    // and our get_subproblem() never calculates sub-problems.
+  }
+
+  const type_value i_count_;
+  type_value current_i_ = 0;
+  std::array<type_subproblem, WINDOW_SIZE> window_;
+  std::vector<type_subproblem> all_;
+};
+
+template <typename T_derived, std::size_t T_COUNT_SUBPROBLEMS_TO_KEEP,
+  typename T_subproblem, typename T_value_type,
+  bool T_RECORD_SUBPROBLEM_ACCESSES>
+constexpr bool DpBottomUp1DBase<T_derived, T_COUNT_SUBPROBLEMS_TO_KEEP,
+  T_subproblem, T_value_type, T_RECORD_SUBPROBLEM_ACCESSES>::KEEP_ALL;
+
+template <typename T_derived, std::size_t T_COUNT_SUBPROBLEMS_TO_KEEP,
+  typename T_subproblem, typename T_value_type,
+  bool T_RECORD_SUBPROBLEM_ACCESSES>
+constexpr std::size_t DpBottomUp1DBase<T_derived, T_COUNT_SUBPROBLEMS_TO_KEEP,
+  T_subproblem, T_value_type, T_RECORD_SUBPROBLEM_ACCESSES>::WINDOW_SIZE;
+
+/** A specialization of DpBottomUpBase for 1D tables, for derived classes that
+ * do not pass themselves to DpBottomUp1DBase, such as DpBottomUpStencilBase.
+ *
+ * This is a DpBottomUp1DBase, but it calls calc_subproblem() via a virtual
+ * call, as the general DpBottomUpBase does, even if the derived class is
+ * final, because calc() is not compiled for each derived class. So it avoids
+ * the general DpBottomUpBase's tuples and circular_vector, but its loop is not
+ * as quick as a hand-written one. Derive from DpBottomUp1DBase directly for
+ * that.
+ */
+template <std::size_t T_COUNT_SUBPROBLEMS_TO_KEEP, typename T_subproblem,
+  typename T_value_type>
+class DpBottomUpBase<T_COUNT_SUBPROBLEMS_TO_KEEP, T_subproblem, T_value_type>
+  : public DpBottomUp1DBase<
+      DpBottomUpBase<T_COUNT_SUBPROBLEMS_TO_KEEP, T_subproblem, T_value_type>,
+      T_COUNT_SUBPROBLEMS_TO_KEEP, T_subproblem, T_value_type> {
+public:
+  using type_1d_base = DpBottomUp1DBase<DpBottomUpBase,
+    T_COUNT_SUBPROBLEMS_TO_KEEP, T_subproblem, T_value_type>;
+  using type_value = typename type_1d_base::type_value;
+
+  /**
+   * @param i_count The number of i values to calculate the subproblem for.
+   */
+  explicit DpBottomUpBase(type_value i_count) : type_1d_base(i_count) {}
 };
 
 } // namespace murraycdp
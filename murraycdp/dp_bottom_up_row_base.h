@@ -0,0 +1,124 @@
+/* Copyright (C) 2016 Murray Cumming
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef MURRAYCDP_DP_BOTTOM_UP_ROW_BASE_H
+#define MURRAYCDP_DP_BOTTOM_UP_ROW_BASE_H
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+#include <murraycdp/dp_bottom_up_base.h>
+
+namespace murraycdp {
+
+/** A base class for a 2D bottom-up dynamic programming algorithm that
+ * calculates a whole row of sub-problems, for one i, at a time.
+ *
+ * Override this, implementing calc_row() instead of calc_subproblem(), and
+ * then call calc() to get the overall solution. As with DpBottomUpBase, calc()
+ * keeps only the last T_COUNT_SUBPROBLEMS_TO_KEEP rows, including the current
+ * one, and gets the goal cell's sub-problem.
+ *
+ * calc_row() gets plain pointers to the rows, so it can be a simple loop over
+ * j, which the compiler can vectorize, instead of a virtual call to
+ * calc_subproblem() per cell, with the tuples that DpBottomUpBase uses for any
+ * count of dimensions.
+ *
+ * @tparam T_COUNT_SUBPROBLEMS_TO_KEEP The number of i values, including the
+ * current one, that calc_row() needs to use. This cannot be 0.
+ * @tparam T_subproblem The type of the subproblem solution, such as unsigned
+ * int.
+ */
+template <std::size_t T_COUNT_SUBPROBLEMS_TO_KEEP, typename T_subproblem,
+  typename T_value_i, typename T_value_j>
+class DpBottomUpRowBase : public DpBottomUpBase<T_COUNT_SUBPROBLEMS_TO_KEEP,
+                            T_subproblem, T_value_i, T_value_j> {
+public:
+  static_assert(T_COUNT_SUBPROBLEMS_TO_KEEP > 0,
+    "DpBottomUpRowBase cannot keep the rows for all i values.");
+
+  using type_base = DpBottomUpBase<T_COUNT_SUBPROBLEMS_TO_KEEP, T_subproblem,
+    T_value_i, T_value_j>;
+  using type_subproblem = T_subproblem;
+  using type_level = typename type_base::type_level;
+  using type_i = typename std::decay<T_value_i>::type;
+  using type_j = typename std::decay<T_value_j>::type;
+
+  /** The rows for i - 1, i - 2, and so on.
+   */
+  using type_previous_rows =
+    std::array<const type_subproblem*, T_COUNT_SUBPROBLEMS_TO_KEEP - 1>;
+
+  /**
+   * @param i_count The number of i values to calculate the rows for.
+   * @param j_count The number of j values in each row.
+   */
+  DpBottomUpRowBase(type_i i_count, type_j j_count)
+  : type_base(i_count, j_count), i_count_(i_count), j_count_(j_count) {}
+
+  type_subproblem
+  calc() override {
+    this->reset_subproblems();
+
+    type_previous_rows previous_rows;
+    for (type_i i = 0; i < i_count_; ++i) {
+      if (i != 0) {
+        this->subproblems_.step();
+      }
+
+      for (std::size_t k = 0; k < previous_rows.size(); ++k) {
+        const auto offset = -static_cast<std::ptrdiff_t>(k + 1);
+        previous_rows[k] = this->subproblems_.get(offset).data();
+      }
+
+      calc_row(i, previous_rows, this->subproblems_.get(0).data(), j_count_);
+    }
+
+    type_i goal_i = 0;
+    type_j goal_j = 0;
+    this->get_goal_cell(goal_i, goal_j);
+    return this->subproblems_.get_at_offset_from_start(goal_i)[goal_j];
+  }
+
+protected:
+  /** Calculate the sub-problems for all j values of i.
+   *
+   * @param previous_rows The rows for i - 1, i - 2, and so on. While i is
+   * less than T_COUNT_SUBPROBLEMS_TO_KEEP - 1, the rows before i 0 have
+   * default sub-problems.
+   * @param row The row to fill, for i.
+   * @param j_count The size of each row.
+   */
+  virtual void
+  calc_row(type_i i, const type_previous_rows& previous_rows,
+    type_subproblem* row, type_j j_count) const = 0;
+
+private:
+  type_subproblem
+  calc_subproblem(type_level /* level */, T_value_i i, T_value_j j) const final {
+    // calc() calls calc_row() instead, so this only gets sub-problems that it
+    // has already calculated, for DpBase::get_subproblem().
+    return this->subproblems_.get_at_offset_from_start(i)[j];
+  }
+
+  const type_i i_count_;
+  const type_j j_count_;
+};
+
+} // namespace murraycdp
+
+#endif // MURRAYCDP_DP_BOTTOM_UP_ROW_BASE_H
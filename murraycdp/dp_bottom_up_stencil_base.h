@@ -0,0 +1,114 @@
+/* Copyright (C) 2016 Murray Cumming
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef MURRAYCDP_DP_BOTTOM_UP_STENCIL_BASE_H
+#define MURRAYCDP_DP_BOTTOM_UP_STENCIL_BASE_H
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <murraycdp/dp_bottom_up_base.h>
+#include <murraycdp/utils/stencil.h>
+
+namespace murraycdp {
+
+/** The count of i values that DpBottomUpBase must keep sub-problems for,
+ * for a stencil.
+ *
+ * The 1D specialization of DpBottomUpBase keeps only the previous values,
+ * but the 2D (or more) DpBottomUpBase also keeps the current i's sub-problems.
+ */
+template <typename T_stencil>
+constexpr std::size_t
+get_count_subproblems_to_keep_for_stencil() {
+  return T_stencil::get_count_i_back() +
+         (T_stencil::COUNT_DIMENSIONS == 1 ? 0 : 1);
+}
+
+/** A DpBottomUpBase whose derived class declares which sub-problems each
+ * sub-problem depends on, as a utils::stencil, instead of choosing a count of
+ * sub-problems to keep.
+ *
+ * For instance, for LCS:
+ * @code
+ * class DpLCS
+ *   : public murraycdp::DpBottomUpStencilBase<
+ *       murraycdp::utils::stencil<murraycdp::utils::offset<-1, -1>,
+ *         murraycdp::utils::offset<-1, 0>, murraycdp::utils::offset<0, -1>>,
+ *       SubSolution, std::size_t, std::size_t> {
+ * @endcode
+ *
+ * The count of i values to keep is then the least that the stencil needs.
+ * In debug builds, get_subproblem() asserts that the sub-problem is one of
+ * the stencil's, relative to the sub-problem being calculated, so it cannot
+ * read a sub-problem that has already been discarded. So get_subproblem()
+ * should only be used in calc_subproblem().
+ *
+ * @tparam T_stencil A utils::stencil<> with the same count of dimensions as
+ * T_value_types.
+ */
+template <typename T_stencil, typename T_subproblem, typename... T_value_types>
+class DpBottomUpStencilBase
+  : public DpBottomUpBase<
+      get_count_subproblems_to_keep_for_stencil<T_stencil>(), T_subproblem,
+      T_value_types...> {
+public:
+  static_assert(T_stencil::COUNT_DIMENSIONS == sizeof...(T_value_types),
+    "The stencil needs an offset for each of the values.");
+
+  using type_base = DpBottomUpBase<
+    get_count_subproblems_to_keep_for_stencil<T_stencil>(), T_subproblem,
+    T_value_types...>;
+  using type_stencil = T_stencil;
+  using type_level = typename type_base::type_level;
+  using type_values = typename type_base::type_values;
+
+  explicit DpBottomUpStencilBase(
+    typename std::decay<T_value_types>::type... value_counts)
+  : type_base(value_counts...) {}
+
+protected:
+  /** Get a sub-problem that calc() has already calculated.
+   * This hides the base class's get_subproblem().
+   */
+  decltype(auto)
+  get_subproblem(type_level level, T_value_types... values) const {
+    assert(is_in_stencil(type_values(values...),
+      std::index_sequence_for<T_value_types...>()));
+
+    return type_base::get_subproblem(level, values...);
+  }
+
+private:
+  template <std::size_t... Is>
+  bool
+  is_in_stencil(
+    const type_values& values, std::index_sequence<Is...>) const {
+    const auto current = this->get_current_cell();
+    const typename T_stencil::type_offsets offsets{
+      {static_cast<std::ptrdiff_t>(std::get<Is>(values)) -
+       static_cast<std::ptrdiff_t>(std::get<Is>(current))...}};
+    return T_stencil::contains(offsets);
+  }
+};
+
+} // namespace murraycdp
+
+#endif // MURRAYCDP_DP_BOTTOM_UP_STENCIL_BASE_H
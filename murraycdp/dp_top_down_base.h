@@ -23,10 +23,12 @@
 #include <iostream>
 #include <limits>
 #include <murraycdp/dp_base.h>
+#include <murraycdp/utils/key_interner.h>
 #include <murraycdp/utils/tuple_hash.h>
 #include <string>
 #include <tuple>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace murraycdp {
@@ -38,6 +40,13 @@ namespace murraycdp {
  * Derive from this class, implementing calc_subproblem(), and get_goal_cell().
  * Then call calc() to get the overall solution.
  *
+ * For branch-and-bound, also implement get_lower_bound() (when minimizing)
+ * or get_upper_bound() (when maximizing), and get sub-problems in
+ * calc_subproblem() with get_subproblem_if_less() or
+ * get_subproblem_if_greater(), passing the best solution so far, or the
+ * limit from get_limit(). Then sub-problems whose bounds show that they
+ * cannot improve on that will not be calculated.
+ *
  * @tparam T_subproblem The type of the subproblem solution, such as unsigned
  * int,
  * or a custom class containing a value and a partial path.
@@ -88,16 +97,168 @@ public:
       goals);
   }
 
-  unsigned int
+  std::size_t
   count_cached_sub_problems() const {
     return subproblems_.size();
   }
 
+  /** The count of calls to calc_subproblem().
+   * With branch-and-bound, this can be more than count_cached_sub_problems(),
+   * because a sub-problem that is not better than its limit is not always
+   * cached, so it might be calculated again, for a different limit.
+   */
+  std::size_t
+  count_calculated_sub_problems() const {
+    return this->get_count_calculated_subproblems();
+  }
+
+  /** The count of sub-problems that were not calculated,
+   * because their bounds showed that they could not improve on the best
+   * solution so far.
+   * See get_subproblem_if_less() and get_subproblem_if_greater().
+   */
+  std::size_t
+  count_skipped_sub_problems() const {
+    return count_skipped_;
+  }
+
 protected:
   void
   clear() override {
     type_base::clear();
     subproblems_.clear();
+    key_interner_.clear();
+    limits_.clear();
+    count_skipped_ = 0;
+    count_rejected_ = 0;
+  }
+
+  /** Override this to give a lower bound for the sub-problem's solution,
+   * for use by get_subproblem_if_less().
+   *
+   * @result false if there is no bound.
+   */
+  virtual bool
+  get_lower_bound(
+    type_subproblem& /* bound */, T_value_types... /* values */) const {
+    return false;
+  }
+
+  /** Override this to give an upper bound for the sub-problem's solution,
+   * for use by get_subproblem_if_greater().
+   *
+   * @result false if there is no bound.
+   */
+  virtual bool
+  get_upper_bound(
+    type_subproblem& /* bound */, T_value_types... /* values */) const {
+    return false;
+  }
+
+  /** Like get_subproblem(), but only gets the sub-problem's solution if it
+   * is less than @a limit, such as the best solution so far.
+   * If the sub-problem has not yet been calculated, and get_lower_bound()
+   * shows that it is not less than @a limit, it is not calculated.
+   *
+   * While it is being calculated, calc_subproblem() can get the @a limit with
+   * get_limit(), to use for its own sub-problems.
+   *
+   * type_subproblem must have operator<().
+   *
+   * @result true, with the sub-problem's solution in @a result, if it is less
+   * than @a limit.
+   */
+  bool
+  get_subproblem_if_less(type_level level, const type_subproblem& limit,
+    type_subproblem& result, T_value_types... values) const {
+    return get_subproblem_if_better(level, limit, result,
+      [](const type_subproblem& a, const type_subproblem& b) { return a < b; },
+      [this](type_subproblem& bound, T_value_types... the_values) {
+        return this->get_lower_bound(bound, the_values...);
+      },
+      values...);
+  }
+
+  /** Like get_subproblem_if_less(), but for maximizing,
+   * with get_upper_bound().
+   *
+   * @result true, with the sub-problem's solution in @a result, if it is
+   * greater than @a limit.
+   */
+  bool
+  get_subproblem_if_greater(type_level level, const type_subproblem& limit,
+    type_subproblem& result, T_value_types... values) const {
+    return get_subproblem_if_better(level, limit, result,
+      [](const type_subproblem& a, const type_subproblem& b) { return b < a; },
+      [this](type_subproblem& bound, T_value_types... the_values) {
+        return this->get_upper_bound(bound, the_values...);
+      },
+      values...);
+  }
+
+  /** Get the limit that was passed to get_subproblem_if_less() or
+   * get_subproblem_if_greater(), if any, when calculating this sub-problem.
+   *
+   * @param level The level passed to calc_subproblem().
+   * @result false if there is no limit.
+   */
+  bool
+  get_limit(type_level level, type_subproblem& limit) const {
+    // A limit only applies to the sub-problem that it was passed for,
+    // not to any sub-problems that that gets via get_subproblem().
+    if (limits_.empty() || limits_.back().first != level) {
+      return false;
+    }
+
+    limit = limits_.back().second;
+    return true;
+  }
+
+  using type_key_interner =
+    utils::key_interner<typename std::decay<T_value_types>::type...>;
+
+  /** The key of a sub-problem in the cache, with any non-scalar values,
+   * such as std::strings or std::vectors, replaced by dense ids.
+   * See intern_key().
+   */
+  using type_key = typename type_key_interner::type_key;
+
+  /** Get the key for the sub-problem's values, for get_subproblem_by_key().
+   *
+   * get_subproblem() must hash any non-scalar values in full, to find their
+   * ids, for every call. So, when calc_subproblem() gets several
+   * sub-problems with the same non-scalar values, it can intern the key once
+   * instead, changing only the key's scalar values, which are their own ids,
+   * with std::get<>().
+   */
+  type_key
+  intern_key(T_value_types... values) const {
+    return key_interner_.intern(values...);
+  }
+
+  /** Like get_subproblem(), but for a key from intern_key(),
+   * so it hashes only the key's ids.
+   */
+  type_subproblem
+  get_subproblem_by_key(type_level level, const type_key& key) const {
+    const auto iter = subproblems_.find(key);
+    if (iter != subproblems_.end()) {
+      key_interner_.call_with_values(key, [this](T_value_types... values) {
+        this->record_subproblem_access(
+          type_base::SubproblemAccess::FROM_CACHE, values...);
+      });
+      return iter->second;
+    }
+
+    ++level;
+    return key_interner_.call_with_values(
+      key, [this, level, &key](T_value_types... values) {
+        const auto result = this->calc_subproblem(level, values...);
+        subproblems_[key] = result;
+        this->record_subproblem_access(
+          type_base::SubproblemAccess::CALCULATED, values...);
+        return result;
+      });
   }
 
   static void
@@ -109,6 +270,56 @@ protected:
   }
 
 private:
+  template <typename T_is_better, typename T_get_bound>
+  bool
+  get_subproblem_if_better(type_level level, const type_subproblem& limit,
+    type_subproblem& result, T_is_better is_better, T_get_bound get_bound,
+    T_value_types... values) const {
+    if (get_cached_subproblem(result, values...)) {
+      this->record_subproblem_access(
+        type_base::SubproblemAccess::FROM_CACHE, values...);
+      if (is_better(result, limit)) {
+        return true;
+      }
+
+      ++count_rejected_;
+      return false;
+    }
+
+    type_subproblem bound;
+    if (get_bound(bound, values...) && !is_better(bound, limit)) {
+      this->record_subproblem_access(
+        type_base::SubproblemAccess::SKIPPED, values...);
+      ++count_skipped_;
+      ++count_rejected_;
+      return false;
+    }
+
+    const auto count_rejected_before = count_rejected_;
+    ++level;
+    limits_.emplace_back(level, limit);
+    result = this->calc_subproblem(level, values...);
+    limits_.pop_back();
+    this->record_subproblem_access(
+      type_base::SubproblemAccess::CALCULATED, values...);
+
+    // A solution that is better than the limit is exact, even if some of its
+    // sub-problems were rejected, because they could not have been better.
+    // Otherwise, it is only exact if none of its sub-problems were rejected.
+    // So we don't cache it if it might be wrong for a different limit.
+    if (is_better(result, limit)) {
+      set_subproblem(result, values...);
+      return true;
+    }
+
+    if (count_rejected_ == count_rejected_before) {
+      set_subproblem(result, values...);
+    }
+
+    ++count_rejected_;
+    return false;
+  }
+
   /** Gets the already-calculated subproblem solution, if any.
    * @result true if the subproblem solution was in the cache.
    */
@@ -117,7 +328,12 @@ private:
     type_subproblem& subproblem, T_value_types... values) const override {
     // std::cout << "get_cached_subproblem(): i=" << i << ", j=" << j <<
     // std::endl;
-    const type_values key(values...);
+    type_key key;
+    if (!key_interner_.find(key, values...)) {
+      subproblem = type_subproblem();
+      return false;
+    }
+
     const auto iter = subproblems_.find(key);
     if (iter == subproblems_.end()) {
       subproblem = type_subproblem();
@@ -133,15 +349,27 @@ private:
   void
   set_subproblem(
     const type_subproblem& subproblem, T_value_types... values) const override {
-    const type_values key(values...);
-    subproblems_[key] = subproblem;
+    subproblems_[key_interner_.intern(values...)] = subproblem;
   }
 
 private:
+  // The keys of the map are the values, but with any non-scalar values,
+  // such as std::strings or std::vectors, replaced by dense ids,
+  // so we don't copy them into every key, or compare them in full in the map.
+  mutable type_key_interner key_interner_;
+
   // Map of values to subproblems:
-  using type_map_subproblems = std::unordered_map<type_values, type_subproblem,
-    utils::hash_tuple::hash<type_values>>;
+  using type_map_subproblems = std::unordered_map<type_key, type_subproblem,
+    utils::hash_tuple::hash<type_key>>;
   mutable type_map_subproblems subproblems_;
+
+  // The levels and limits of the sub-problems being calculated by
+  // get_subproblem_if_better().
+  mutable std::vector<std::pair<type_level, type_subproblem>> limits_;
+  mutable std::size_t count_skipped_ = 0;
+
+  // Including sub-problems that were calculated but were not better:
+  mutable std::size_t count_rejected_ = 0;
 };
 
 } // namespace murraycdp
@@ -0,0 +1,725 @@
+/* Copyright (C) 2016 Murray Cumming
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef MURRAYCDP_BIG_UNSIGNED_H
+#define MURRAYCDP_BIG_UNSIGNED_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace murraycdp {
+namespace utils {
+
+/**
+ * An unsigned integer of any size, for counting dynamic programming
+ * problems whose counts overflow the built-in types, such as the fibonacci
+ * numbers past F(93).
+ *
+ * It can be used as the T_subproblem of a DpTopDownBase or DpBottomUpBase,
+ * because it can be default-constructed (as 0), copied, added, and compared,
+ * like the built-in types.
+ *
+ * Multiplication uses Karatsuba's algorithm for large numbers, so it takes
+ * O(n^1.585) time for numbers of n limbs, and Toom-3 for even larger numbers,
+ * taking O(n^1.465) time.
+ * to_string() takes O(n^2) time, so it is only useful for smaller numbers.
+ */
+class big_unsigned {
+public:
+  using size_type = std::size_t;
+
+  big_unsigned() = default;
+
+  /** This is not explicit, so that, for instance, 0 and 1 can be used as
+   * base cases.
+   */
+  big_unsigned(unsigned long long value) {
+    while (value > 0) {
+      limbs_.emplace_back(static_cast<type_limb>(value));
+      value = (BITS_PER_LIMB < 64) ? (value >> (BITS_PER_LIMB % 64)) : 0;
+    }
+  }
+
+  big_unsigned(const big_unsigned& src) = default;
+  big_unsigned&
+  operator=(const big_unsigned& src) = default;
+
+  big_unsigned(big_unsigned&& src) noexcept = default;
+  big_unsigned&
+  operator=(big_unsigned&& src) noexcept = default;
+
+  bool
+  is_zero() const {
+    return limbs_.empty();
+  }
+
+  /** The count of bits needed for this number, without leading zeros.
+   */
+  size_type
+  bit_count() const {
+    if (limbs_.empty()) {
+      return 0;
+    }
+
+    auto top = limbs_.back();
+    size_type result = (limbs_.size() - 1) * BITS_PER_LIMB;
+    while (top > 0) {
+      ++result;
+      top >>= 1;
+    }
+
+    return result;
+  }
+
+  /** This number modulo 2^64.
+   */
+  unsigned long long
+  get_low_bits() const {
+    unsigned long long result = 0;
+    for (size_type i = 0; i < limbs_.size() && i * BITS_PER_LIMB < 64; ++i) {
+      result |= static_cast<unsigned long long>(limbs_[i])
+                << (i * BITS_PER_LIMB);
+    }
+
+    return result;
+  }
+
+  /** This number modulo @a divisor.
+   */
+  std::uint32_t
+  remainder(std::uint32_t divisor) const {
+    assert(divisor != 0);
+
+    type_double_limb result = 0;
+    for (auto iter = limbs_.rbegin(); iter != limbs_.rend(); ++iter) {
+      result = ((result << BITS_PER_LIMB) | *iter) % divisor;
+    }
+
+    return static_cast<std::uint32_t>(result);
+  }
+
+  /** The decimal representation of this number.
+   */
+  std::string
+  to_string() const {
+    if (limbs_.empty()) {
+      return "0";
+    }
+
+    // Divide by the largest power of 10 that fits in a limb,
+    // getting several digits at a time, from the lowest:
+    std::vector<type_limb> quotient = limbs_;
+    std::vector<type_limb> chunks;
+    while (!quotient.empty()) {
+      type_double_limb remainder = 0;
+      for (auto iter = quotient.rbegin(); iter != quotient.rend(); ++iter) {
+        const type_double_limb current =
+          (remainder << BITS_PER_LIMB) | *iter;
+        *iter = static_cast<type_limb>(current / DECIMAL_CHUNK);
+        remainder = current % DECIMAL_CHUNK;
+      }
+
+      chunks.emplace_back(static_cast<type_limb>(remainder));
+      trim(quotient);
+    }
+
+    std::string result = std::to_string(chunks.back());
+    for (auto iter = chunks.rbegin() + 1; iter != chunks.rend(); ++iter) {
+      const auto digits = std::to_string(*iter);
+      result.append(DECIMAL_CHUNK_DIGITS - digits.size(), '0');
+      result += digits;
+    }
+
+    return result;
+  }
+
+  big_unsigned&
+  operator+=(const big_unsigned& b) {
+    if (limbs_.size() < b.limbs_.size()) {
+      limbs_.resize(b.limbs_.size());
+    }
+
+    const auto carry =
+      add_in_place(limbs_.data(), limbs_.size(), b.limbs_.data(), b.limbs_.size());
+    if (carry) {
+      limbs_.emplace_back(carry);
+    }
+
+    return *this;
+  }
+
+  /** Subtract @a b, which must not be more than this number.
+   */
+  big_unsigned&
+  operator-=(const big_unsigned& b) {
+    assert(!(*this < b));
+    subtract_in_place(
+      limbs_.data(), limbs_.size(), b.limbs_.data(), b.limbs_.size());
+    trim(limbs_);
+    return *this;
+  }
+
+  big_unsigned&
+  operator*=(const big_unsigned& b) {
+    *this = *this * b;
+    return *this;
+  }
+
+  friend big_unsigned
+  operator*(const big_unsigned& a, const big_unsigned& b) {
+    big_unsigned result;
+    if (a.is_zero() || b.is_zero()) {
+      return result;
+    }
+
+    result.limbs_.resize(a.limbs_.size() + b.limbs_.size());
+    multiply_limbs(a.limbs_.data(), a.limbs_.size(), b.limbs_.data(),
+      b.limbs_.size(), result.limbs_.data());
+    trim(result.limbs_);
+    return result;
+  }
+
+  friend bool
+  operator==(const big_unsigned& a, const big_unsigned& b) {
+    return a.limbs_ == b.limbs_;
+  }
+
+  friend bool
+  operator<(const big_unsigned& a, const big_unsigned& b) {
+    return is_less(a.limbs_, b.limbs_);
+  }
+
+private:
+#if defined(__SIZEOF_INT128__)
+  using type_limb = std::uint64_t;
+  // __extension__ avoids a -pedantic warning about __int128:
+  __extension__ typedef unsigned __int128 type_double_limb;
+  static constexpr type_limb DECIMAL_CHUNK = 10000000000000000000ull;
+  static constexpr std::size_t DECIMAL_CHUNK_DIGITS = 19;
+#else
+  using type_limb = std::uint32_t;
+  using type_double_limb = std::uint64_t;
+  static constexpr type_limb DECIMAL_CHUNK = 1000000000u;
+  static constexpr std::size_t DECIMAL_CHUNK_DIGITS = 9;
+#endif
+
+  static constexpr std::size_t BITS_PER_LIMB = sizeof(type_limb) * 8;
+
+  /** Below this count of limbs, the simple O(n^2) multiplication is quicker.
+   */
+  static constexpr std::size_t KARATSUBA_THRESHOLD = 32;
+
+  /** Below this count of limbs, Karatsuba's algorithm is quicker than Toom-3.
+   */
+  static constexpr std::size_t TOOM3_THRESHOLD = 200;
+
+  /** A number that can be negative, for Toom-3's intermediate results.
+   */
+  class signed_limbs {
+  public:
+    // The least significant limb first, with no leading zero limbs:
+    std::vector<type_limb> limbs;
+    bool negative = false;
+  };
+
+  /** Remove leading zero limbs, so that 0 has no limbs.
+   */
+  static void
+  trim(std::vector<type_limb>& limbs) {
+    while (!limbs.empty() && limbs.back() == 0) {
+      limbs.pop_back();
+    }
+  }
+
+  /** Add @a b to @a a, which must not be shorter.
+   * @result The carry out of the last limb of @a a.
+   */
+  static type_limb
+  add_in_place(
+    type_limb* a, size_type a_size, const type_limb* b, size_type b_size) {
+    assert(a_size >= b_size);
+
+    type_limb carry = 0;
+    size_type i = 0;
+    for (; i < b_size; ++i) {
+      const type_double_limb sum =
+        static_cast<type_double_limb>(a[i]) + b[i] + carry;
+      a[i] = static_cast<type_limb>(sum);
+      carry = static_cast<type_limb>(sum >> BITS_PER_LIMB);
+    }
+
+    for (; carry && i < a_size; ++i) {
+      carry = (++a[i] == 0) ? 1 : 0;
+    }
+
+    return carry;
+  }
+
+  /** Subtract @a b from @a a, which must not be less than @a b.
+   */
+  static void
+  subtract_in_place(
+    type_limb* a, size_type a_size, const type_limb* b, size_type b_size) {
+    assert(a_size >= b_size);
+
+    type_limb borrow = 0;
+    size_type i = 0;
+    for (; i < b_size; ++i) {
+      const type_limb b_i = b[i];
+      const type_limb difference = a[i] - b_i - borrow;
+      borrow = (a[i] < b_i || (a[i] == b_i && borrow)) ? 1 : 0;
+      a[i] = difference;
+    }
+
+    for (; borrow && i < a_size; ++i) {
+      borrow = (a[i]-- == 0) ? 1 : 0;
+    }
+
+    assert(!borrow);
+  }
+
+  /** Put a * b in @a result, which must have a_size + b_size limbs.
+   */
+  static void
+  multiply_limbs(const type_limb* a, size_type a_size, const type_limb* b,
+    size_type b_size, type_limb* result) {
+    if (a_size < b_size) {
+      std::swap(a, b);
+      std::swap(a_size, b_size);
+    }
+
+    if (b_size < KARATSUBA_THRESHOLD) {
+      multiply_simply(a, a_size, b, b_size, result);
+      return;
+    }
+
+    if (b_size >= TOOM3_THRESHOLD && a_size < 2 * b_size) {
+      multiply_toom3(a, a_size, b, b_size, result);
+      return;
+    }
+
+    if (a_size == b_size) {
+      std::vector<type_limb> scratch(get_karatsuba_scratch_size(a_size));
+      multiply_karatsuba(a, b, a_size, result, scratch.data());
+      return;
+    }
+
+    if (a_size < 2 * b_size) {
+      // Karatsuba needs equal sizes, so pad b with leading zeros:
+      std::vector<type_limb> b_padded(b, b + b_size);
+      b_padded.resize(a_size);
+      std::vector<type_limb> product(2 * a_size);
+      std::vector<type_limb> scratch(get_karatsuba_scratch_size(a_size));
+      multiply_karatsuba(
+        a, b_padded.data(), a_size, product.data(), scratch.data());
+      std::copy(product.begin(), product.begin() + a_size + b_size, result);
+      return;
+    }
+
+    // Multiply b by each b-sized piece of a:
+    std::fill(result, result + a_size + b_size, 0);
+    std::vector<type_limb> product(2 * b_size);
+    for (size_type offset = 0; offset < a_size; offset += b_size) {
+      const auto piece_size = std::min(b_size, a_size - offset);
+      multiply_limbs(a + offset, piece_size, b, b_size, product.data());
+      add_in_place(result + offset, a_size + b_size - offset, product.data(),
+        piece_size + b_size);
+    }
+  }
+
+  /** The count of limbs that multiply_karatsuba() needs for its
+   * intermediate results, for each size at each level of recursion.
+   */
+  static size_type
+  get_karatsuba_scratch_size(size_type size) {
+    if (size < KARATSUBA_THRESHOLD) {
+      return 0;
+    }
+
+    const auto h = size - size / 2;
+    return std::max(get_karatsuba_scratch_size(h),
+      4 * (h + 1) + get_karatsuba_scratch_size(h + 1));
+  }
+
+  /** Put a * b in @a result, which must have 2 * size limbs.
+   *
+   * With a = a1 * B^m + a0 and b = b1 * B^m + b0, this uses only 3
+   * multiplications of half the size, instead of 4:
+   *   a * b = a1 * b1 * B^2m
+   *           + ((a0 + a1) * (b0 + b1) - a0 * b0 - a1 * b1) * B^m
+   *           + a0 * b0
+   *
+   * @param scratch get_karatsuba_scratch_size(size) limbs, so we don't need
+   * to allocate memory at each level of recursion.
+   */
+  static void
+  multiply_karatsuba(const type_limb* a, const type_limb* b, size_type size,
+    type_limb* result, type_limb* scratch) {
+    if (size < KARATSUBA_THRESHOLD) {
+      if (a == b) {
+        square_simply(a, size, result);
+      } else {
+        multiply_simply(a, size, b, size, result);
+      }
+
+      return;
+    }
+
+    const auto m = size / 2;
+    const auto h = size - m;
+    multiply_karatsuba(a, b, m, result, scratch);
+    multiply_karatsuba(a + m, b + m, h, result + 2 * m, scratch);
+
+    // When squaring, the sums are the same, so the middle product is a
+    // square too:
+    type_limb* a_sum = scratch;
+    a_sum[h] = add_limbs(a_sum, a + m, h, a, m);
+    const type_limb* b_sum = a_sum;
+    if (a != b) {
+      type_limb* b_sum_writable = a_sum + h + 1;
+      b_sum_writable[h] = add_limbs(b_sum_writable, b + m, h, b, m);
+      b_sum = b_sum_writable;
+    }
+
+    type_limb* middle = scratch + 2 * (h + 1);
+    const auto middle_size = 2 * (h + 1);
+    multiply_karatsuba(
+      a_sum, b_sum, h + 1, middle, scratch + 2 * middle_size);
+    subtract_in_place(middle, middle_size, result, 2 * m);
+    subtract_in_place(middle, middle_size, result + 2 * m, 2 * h);
+
+    // The middle product fits in size + 1 limbs, so its leading limbs are 0:
+    const auto carry = add_in_place(
+      result + m, 2 * size - m, middle, std::min(middle_size, size + 1));
+    assert(!carry);
+    (void)carry;
+  }
+
+  /** Put a * b in @a result, which must have a_size + b_size limbs, with
+   * a_size >= b_size > a_size / 2.
+   *
+   * This splits a and b into 3 pieces, as polynomials in x = B^k:
+   *   a = a2 * x^2 + a1 * x + a0
+   * and gets the 5 coefficients of their product from its values at
+   * x = 0, 1, -1, -2 and infinity, using only 5 multiplications of a third of
+   * the size, instead of 9, with Bodrato's sequence of exact divisions.
+   */
+  static void
+  multiply_toom3(const type_limb* a, size_type a_size, const type_limb* b,
+    size_type b_size, type_limb* result) {
+    const auto k = (a_size + 2) / 3;
+    const bool squaring = (a == b && a_size == b_size);
+
+    signed_limbs a_values[5];
+    get_toom3_values(a, a_size, k, a_values);
+
+    signed_limbs b_values_if_different[5];
+    const signed_limbs* b_values = a_values;
+    if (!squaring) {
+      get_toom3_values(b, b_size, k, b_values_if_different);
+      b_values = b_values_if_different;
+    }
+
+    // The product's values at x = 0, 1, -1, -2 and infinity:
+    signed_limbs r[5];
+    for (auto i = 0; i < 5; ++i) {
+      r[i] = multiply_signed(a_values[i], b_values[i]);
+    }
+
+    auto& r0 = r[0];
+    auto& r1 = r[1];
+    auto& r2 = r[2]; // The value at -1, until it becomes a coefficient.
+    auto& r3 = r[3]; // The value at -2, until it becomes a coefficient.
+    const auto& r4 = r[4];
+
+    // Interpolate, to get the coefficients:
+    add_signed(r3, r1, true);
+    divide_exactly(r3.limbs, 3);
+    auto r_minus_1 = r2;
+    add_signed(r1, r_minus_1, true);
+    divide_exactly(r1.limbs, 2);
+    add_signed(r2, r0, true);
+    auto r2_minus_r3 = r2;
+    add_signed(r2_minus_r3, r3, true);
+    divide_exactly(r2_minus_r3.limbs, 2);
+    r3 = std::move(r2_minus_r3);
+    add_signed(r3, r4, false);
+    add_signed(r3, r4, false);
+    add_signed(r2, r1, false);
+    add_signed(r2, r4, true);
+    add_signed(r1, r3, true);
+
+    // Add the coefficients, which cannot be negative, at their offsets:
+    const auto result_size = a_size + b_size;
+    std::fill(result, result + result_size, 0);
+    for (size_type i = 0; i < 5; ++i) {
+      const auto& coefficient = r[i];
+      assert(!coefficient.negative);
+      if (coefficient.limbs.empty()) {
+        continue;
+      }
+
+      const auto offset = i * k;
+      const auto carry = add_in_place(result + offset, result_size - offset,
+        coefficient.limbs.data(), coefficient.limbs.size());
+      assert(!carry);
+      (void)carry;
+    }
+  }
+
+  /** Get the values of a, split into 3 pieces of @a k limbs, at
+   * x = 0, 1, -1, -2 and infinity.
+   */
+  static void
+  get_toom3_values(
+    const type_limb* a, size_type a_size, size_type k, signed_limbs* values) {
+    signed_limbs pieces[3];
+    for (size_type i = 0; i < 3; ++i) {
+      const auto start = std::min(i * k, a_size);
+      const auto end = std::min(start + k, a_size);
+      pieces[i].limbs.assign(a + start, a + end);
+      trim(pieces[i].limbs);
+    }
+
+    auto& value_1 = values[1];
+    auto& value_minus_1 = values[2];
+    auto& value_minus_2 = values[3];
+
+    // a0 + a2, then a(1) = a0 + a1 + a2, and a(-1) = a0 - a1 + a2:
+    value_1 = pieces[0];
+    add_signed(value_1, pieces[2], false);
+    value_minus_1 = value_1;
+    add_signed(value_1, pieces[1], false);
+    add_signed(value_minus_1, pieces[1], true);
+
+    // a(-2) = 2 * (a(-1) + a2) - a0:
+    value_minus_2 = value_minus_1;
+    add_signed(value_minus_2, pieces[2], false);
+    add_signed(value_minus_2, value_minus_2, false);
+    add_signed(value_minus_2, pieces[0], true);
+
+    values[0] = std::move(pieces[0]);
+    values[4] = std::move(pieces[2]);
+  }
+
+  /** Multiply 2 signed numbers, or square one, if they are the same object.
+   */
+  static signed_limbs
+  multiply_signed(const signed_limbs& a, const signed_limbs& b) {
+    signed_limbs result;
+    if (a.limbs.empty() || b.limbs.empty()) {
+      return result;
+    }
+
+    result.limbs.resize(a.limbs.size() + b.limbs.size());
+    multiply_limbs(a.limbs.data(), a.limbs.size(), b.limbs.data(),
+      b.limbs.size(), result.limbs.data());
+    trim(result.limbs);
+    result.negative = (a.negative != b.negative);
+    return result;
+  }
+
+  /** Add @a b to @a a, or subtract it.
+   * @a b may be @a a.
+   */
+  static void
+  add_signed(signed_limbs& a, const signed_limbs& b, bool subtract) {
+    const bool b_negative = (b.negative != subtract);
+    if (a.negative == b_negative) {
+      const auto b_size = b.limbs.size();
+      if (a.limbs.size() < b_size) {
+        a.limbs.resize(b_size);
+      }
+
+      const auto carry =
+        add_in_place(a.limbs.data(), a.limbs.size(), b.limbs.data(), b_size);
+      if (carry) {
+        a.limbs.emplace_back(carry);
+      }
+    } else if (!is_less(a.limbs, b.limbs)) {
+      subtract_in_place(
+        a.limbs.data(), a.limbs.size(), b.limbs.data(), b.limbs.size());
+      trim(a.limbs);
+    } else {
+      auto difference = b.limbs;
+      subtract_in_place(difference.data(), difference.size(), a.limbs.data(),
+        a.limbs.size());
+      trim(difference);
+      a.limbs = std::move(difference);
+      a.negative = b_negative;
+    }
+
+    if (a.limbs.empty()) {
+      a.negative = false;
+    }
+  }
+
+  /** Divide @a limbs by @a divisor, which must divide it exactly.
+   */
+  static void
+  divide_exactly(std::vector<type_limb>& limbs, type_limb divisor) {
+    type_double_limb remainder = 0;
+    for (auto iter = limbs.rbegin(); iter != limbs.rend(); ++iter) {
+      const type_double_limb current = (remainder << BITS_PER_LIMB) | *iter;
+      *iter = static_cast<type_limb>(current / divisor);
+      remainder = current % divisor;
+    }
+
+    assert(remainder == 0);
+    trim(limbs);
+  }
+
+  /** Whether the number in @a a, with no leading zero limbs, is less than
+   * the one in @a b.
+   */
+  static bool
+  is_less(const std::vector<type_limb>& a, const std::vector<type_limb>& b) {
+    if (a.size() != b.size()) {
+      return a.size() < b.size();
+    }
+
+    return std::lexicographical_compare(
+      a.rbegin(), a.rend(), b.rbegin(), b.rend());
+  }
+
+  /** Put a + b in @a result, which must have a_size limbs.
+   * @result The carry.
+   */
+  static type_limb
+  add_limbs(type_limb* result, const type_limb* a, size_type a_size,
+    const type_limb* b, size_type b_size) {
+    std::copy(a, a + a_size, result);
+    return add_in_place(result, a_size, b, b_size);
+  }
+
+  /** Put a * b in @a result, which must have a_size + b_size limbs, in
+   * O(a_size * b_size) time.
+   */
+  static void
+  multiply_simply(const type_limb* a, size_type a_size, const type_limb* b,
+    size_type b_size, type_limb* result) {
+    std::fill(result, result + a_size + b_size, 0);
+    for (size_type i = 0; i < a_size; ++i) {
+      // Multiplying two limbs, each cast to a double limb, instead of a
+      // double limb by a limb, lets the compiler use one widening multiply:
+      const type_limb a_i = a[i];
+      type_limb carry = 0;
+      for (size_type j = 0; j < b_size; ++j) {
+        const type_double_limb product =
+          static_cast<type_double_limb>(a_i) * b[j] + result[i + j] + carry;
+        result[i + j] = static_cast<type_limb>(product);
+        carry = static_cast<type_limb>(product >> BITS_PER_LIMB);
+      }
+
+      result[i + b_size] = carry;
+    }
+  }
+
+  /** Put a * a in @a result, which must have 2 * size limbs.
+   * This calculates each product of 2 different limbs only once, so it is
+   * almost twice as quick as multiply_simply().
+   */
+  static void
+  square_simply(const type_limb* a, size_type size, type_limb* result) {
+    std::fill(result, result + 2 * size, 0);
+
+    // The products of different limbs:
+    for (size_type i = 0; i < size; ++i) {
+      const type_limb a_i = a[i];
+      type_limb carry = 0;
+      for (size_type j = i + 1; j < size; ++j) {
+        const type_double_limb product =
+          static_cast<type_double_limb>(a_i) * a[j] + result[i + j] + carry;
+        result[i + j] = static_cast<type_limb>(product);
+        carry = static_cast<type_limb>(product >> BITS_PER_LIMB);
+      }
+
+      result[i + size] = carry;
+    }
+
+    // Each of those appears twice:
+    type_limb high_bit = 0;
+    for (size_type i = 0; i < 2 * size; ++i) {
+      const auto limb = result[i];
+      result[i] = (limb << 1) | high_bit;
+      high_bit = limb >> (BITS_PER_LIMB - 1);
+    }
+
+    // The squares of each limb:
+    type_limb carry = 0;
+    for (size_type i = 0; i < size; ++i) {
+      const type_double_limb square =
+        static_cast<type_double_limb>(a[i]) * a[i] + result[2 * i] + carry;
+      result[2 * i] = static_cast<type_limb>(square);
+      const type_double_limb high =
+        static_cast<type_double_limb>(result[2 * i + 1]) +
+        static_cast<type_limb>(square >> BITS_PER_LIMB);
+      result[2 * i + 1] = static_cast<type_limb>(high);
+      carry = static_cast<type_limb>(high >> BITS_PER_LIMB);
+    }
+  }
+
+  // The least significant limb first, with no leading zero limbs:
+  std::vector<type_limb> limbs_;
+};
+
+inline big_unsigned
+operator+(big_unsigned a, const big_unsigned& b) {
+  a += b;
+  return a;
+}
+
+inline big_unsigned
+operator-(big_unsigned a, const big_unsigned& b) {
+  a -= b;
+  return a;
+}
+
+inline bool
+operator!=(const big_unsigned& a, const big_unsigned& b) {
+  return !(a == b);
+}
+
+inline bool
+operator>(const big_unsigned& a, const big_unsigned& b) {
+  return b < a;
+}
+
+inline bool
+operator<=(const big_unsigned& a, const big_unsigned& b) {
+  return !(b < a);
+}
+
+inline bool
+operator>=(const big_unsigned& a, const big_unsigned& b) {
+  return !(a < b);
+}
+
+inline std::ostream&
+operator<<(std::ostream& stream, const big_unsigned& value) {
+  stream << value.to_string();
+  return stream;
+}
+
+} // namespace utils
+} // namespace murraycdp
+
+#endif // MURRAYCDP_BIG_UNSIGNED_H
@@ -17,6 +17,9 @@
 #ifndef MURRAYCDP_CIRCULAR_VECTOR_H
 #define MURRAYCDP_CIRCULAR_VECTOR_H
 
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
 #include <vector>
 
 namespace murraycdp {
@@ -26,6 +29,7 @@ template <typename T>
 class circular_vector {
 public:
   using size_type = typename std::vector<T>::size_type;
+  using difference_type = typename std::vector<T>::difference_type;
 
   /**
    * Create a circular vector of size @a size,
@@ -35,25 +39,25 @@ public:
   : pos_zero_(0), steps_count_(0), size_(size), vec_(size, value) {}
 
   T&
-  get(int offset) {
+  get(difference_type offset) {
     const auto pos = pos_for_offset(offset);
     return vec_[pos];
   }
 
   const T&
-  get(int offset) const {
+  get(difference_type offset) const {
     const auto pos = pos_for_offset(offset);
     return vec_[pos];
   }
 
   T&
-  get_at_offset_from_start(int offset) {
-    return get(get_offset_from_start(offset));
+  get_at_offset_from_start(size_type index) {
+    return get(get_offset_from_start(index));
   }
 
   const T&
-  get_at_offset_from_start(int offset) const {
-    return get(get_offset_from_start(offset));
+  get_at_offset_from_start(size_type index) const {
+    return get(get_offset_from_start(index));
   }
 
   /** Cause get(-1) to return whatever get(0) currently returns.
@@ -63,10 +67,17 @@ public:
     ++steps_count_;
 
     ++pos_zero_;
-    if (pos_zero_ >= (int)size_)
+    if (pos_zero_ >= size_)
       pos_zero_ = 0;
   }
 
+  /** Returns which index get(0) now represents.
+   */
+  size_type
+  steps_count() const {
+    return steps_count_;
+  }
+
   size_type
   size() const {
     return size_;
@@ -79,11 +90,13 @@ public:
     }
   }
 
+  /** Set every item to @a value, and make get(0) the first item again.
+   */
   void
-  clear() {
+  clear(const T& value = T()) {
     pos_zero_ = 0;
     steps_count_ = 0;
-    // TODO: Wipe the actual data.
+    std::fill(std::begin(vec_), std::end(vec_), value);
   }
 
 private:
@@ -91,14 +104,12 @@ private:
    * wrapping around if necessary.
    */
   size_type
-  pos_for_offset(int offset) const {
-    if (offset >= (int)size_) {
-      std::cerr << "offset too large: " << offset << std::endl;
-    }
+  pos_for_offset(difference_type offset) const {
+    assert(std::abs(offset) < static_cast<difference_type>(size_));
 
-    int pos = pos_zero_ + offset;
-    if (pos >= (int)size_)
-      return 0 + (size_ - pos);
+    const auto pos = static_cast<difference_type>(pos_zero_) + offset;
+    if (pos >= static_cast<difference_type>(size_))
+      return pos - size_;
     else if (pos < 0)
       return size_ + pos;
     else
@@ -107,30 +118,22 @@ private:
 
   /** For instance, get the 5th item,
    * regardless of how many times we have called step().
-   * This can fail if the @a offset is greater than size().
+   * This can fail if the @a index is more than size() from steps_count().
    */
-  int
-  get_offset_from_start(int offset) const {
-    const int current_offset = offset - steps_count();
-    if (std::abs(current_offset) > (int)size()) {
-      std::cerr << "Item has already been discarded. size=" << size()
-                << ", current_offset=" << current_offset << std::endl;
-      return 0;
-    }
+  difference_type
+  get_offset_from_start(size_type index) const {
+    const auto current_offset = static_cast<difference_type>(index) -
+                                static_cast<difference_type>(steps_count());
 
-    return current_offset;
-  }
+    // Otherwise the item has already been discarded:
+    assert(std::abs(current_offset) < static_cast<difference_type>(size()));
 
-  /** Returns which index get(0) now represents.
-   */
-  int
-  steps_count() const {
-    return steps_count_;
+    return current_offset;
   }
 
-  int pos_zero_;
-  int steps_count_;
-  unsigned int size_;
+  size_type pos_zero_;
+  size_type steps_count_;
+  size_type size_;
   std::vector<T> vec_;
 };
 
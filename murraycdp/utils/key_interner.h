@@ -0,0 +1,266 @@
+/* Copyright (C) 2016 Murray Cumming
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef MURRAYCDP_KEY_INTERNER_H
+#define MURRAYCDP_KEY_INTERNER_H
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace murraycdp {
+namespace utils {
+
+/** Whether key_interner should replace values of this type with dense ids.
+ * Scalars, such as integers and enums, are already cheap to copy, compare,
+ * and hash, so they are used as they are.
+ */
+template <typename T_value>
+class is_interned
+  : public std::integral_constant<bool, !std::is_scalar<T_value>::value> {};
+
+/** Maps the values of one component of a key to dense ids.
+ * See key_interner.
+ */
+template <typename T_value, bool T_interned = is_interned<T_value>::value>
+class key_component_interner;
+
+/** Scalars are their own ids.
+ */
+template <typename T_value>
+class key_component_interner<T_value, false> {
+public:
+  using type_id = T_value;
+
+  bool
+  find(const T_value& value, type_id& id) const {
+    id = value;
+    return true;
+  }
+
+  type_id
+  intern(const T_value& value) {
+    return value;
+  }
+
+  T_value
+  get_value(type_id id) const {
+    return id;
+  }
+
+  std::size_t
+  size() const {
+    return 0;
+  }
+
+  void
+  clear() {}
+};
+
+/** Other values are copied and hashed once, when they are first interned,
+ * and are then represented by their id.
+ * T_value must have a std::hash<> specialization and operator==().
+ */
+template <typename T_value>
+class key_component_interner<T_value, true> {
+public:
+  using type_id = std::size_t;
+
+  bool
+  find(const T_value& value, type_id& id) const {
+    const auto iter = ids_.find(value);
+    if (iter == ids_.end()) {
+      return false;
+    }
+
+    id = iter->second;
+    return true;
+  }
+
+  type_id
+  intern(const T_value& value) {
+    const auto inserted = ids_.emplace(value, ids_.size());
+    if (inserted.second) {
+      // Keys of an unordered_map are not moved when it is rehashed,
+      // so we can point to them.
+      values_.emplace_back(&(inserted.first->first));
+    }
+
+    return inserted.first->second;
+  }
+
+  /** Get the value that was interned as @a id.
+   */
+  const T_value&
+  get_value(type_id id) const {
+    return *values_[id];
+  }
+
+  /** The count of different values interned so far.
+   */
+  std::size_t
+  size() const {
+    return ids_.size();
+  }
+
+  void
+  clear() {
+    ids_.clear();
+    values_.clear();
+  }
+
+private:
+  std::unordered_map<T_value, type_id> ids_;
+  std::vector<const T_value*> values_;
+};
+
+/**
+ * Maps keys made of several values to tuples of integers, for use as cheap
+ * keys in a cache, such as in DpTopDownBase.
+ *
+ * Each non-scalar value, such as a std::string or a std::vector<>,
+ * is replaced by a dense id, so the key doesn't need to copy the value,
+ * and comparing or hashing the key is O(1), instead of O(size of the value).
+ *
+ * However, find() and intern() must still hash each non-scalar value in full
+ * to get its id. So, to avoid that for every lookup, intern the key once, and
+ * keep it. Scalar values are their own ids, so they can then be changed in the
+ * key with std::get<>(), and call_with_values() gets the values back from a
+ * key. See DpTopDownBase::intern_key() and
+ * DpTopDownBase::get_subproblem_by_key().
+ *
+ * For instance:
+ * @code
+ *   key_interner<std::size_t, std::string> interner;
+ *   const auto key = interner.intern(3, "noun-phrase");
+ *   key_interner<std::size_t, std::string>::type_key found;
+ *   if (interner.find(found, 3, "noun-phrase")) { ... }
+ * @endcode
+ *
+ * @tparam T_values The (decayed) types of the values in the key.
+ */
+template <typename... T_values>
+class key_interner {
+public:
+  using type_key =
+    std::tuple<typename key_component_interner<T_values>::type_id...>;
+
+  key_interner() = default;
+
+  key_interner(const key_interner& src) = default;
+  key_interner&
+  operator=(const key_interner& src) = default;
+
+  key_interner(key_interner&& src) noexcept = default;
+  key_interner&
+  operator=(key_interner&& src) noexcept = default;
+
+  /** Get the key for the values, without interning any new values.
+   * @result false if any of the values has not been interned,
+   * so there can be no such key yet.
+   */
+  bool
+  find(type_key& key, const T_values&... values) const {
+    return find(key, std::index_sequence_for<T_values...>(), values...);
+  }
+
+  /** Get the key for the values, interning any values that have not yet been
+   * interned.
+   */
+  type_key
+  intern(const T_values&... values) {
+    return intern(std::index_sequence_for<T_values...>(), values...);
+  }
+
+  /** Call @a function with the values that @a key was interned from.
+   * Non-scalar values are passed as const references to the interned copies,
+   * which stay valid until clear().
+   */
+  template <typename T_function>
+  decltype(auto)
+  call_with_values(const type_key& key, T_function function) const {
+    return call_with_values(
+      key, function, std::index_sequence_for<T_values...>());
+  }
+
+  /** The count of different non-scalar values interned so far.
+   */
+  std::size_t
+  size() const {
+    return size(std::index_sequence_for<T_values...>());
+  }
+
+  void
+  clear() {
+    clear(std::index_sequence_for<T_values...>());
+  }
+
+private:
+  template <std::size_t... Is>
+  bool
+  find(type_key& key, std::index_sequence<Is...>,
+    const T_values&... values) const {
+    bool found = true;
+    // Expand the pack in an array initializer, so it's evaluated in order:
+    const bool results[] = {
+      true, (found = found && std::get<Is>(components_).find(
+                                 values, std::get<Is>(key)))...};
+    static_cast<void>(results);
+    return found;
+  }
+
+  template <std::size_t... Is>
+  type_key
+  intern(std::index_sequence<Is...>, const T_values&... values) {
+    return type_key(std::get<Is>(components_).intern(values)...);
+  }
+
+  template <typename T_function, std::size_t... Is>
+  decltype(auto)
+  call_with_values(const type_key& key, T_function function,
+    std::index_sequence<Is...>) const {
+    return function(std::get<Is>(components_).get_value(std::get<Is>(key))...);
+  }
+
+  template <std::size_t... Is>
+  std::size_t
+  size(std::index_sequence<Is...>) const {
+    std::size_t result = 0;
+    const std::size_t sizes[] = {0, std::get<Is>(components_).size()...};
+    for (const auto component_size : sizes) {
+      result += component_size;
+    }
+
+    return result;
+  }
+
+  template <std::size_t... Is>
+  void
+  clear(std::index_sequence<Is...>) {
+    const int results[] = {0, (std::get<Is>(components_).clear(), 0)...};
+    static_cast<void>(results);
+  }
+
+  std::tuple<key_component_interner<T_values>...> components_;
+};
+
+} // namespace utils
+} // namespace murraycdp
+
+#endif // MURRAYCDP_KEY_INTERNER_H
@@ -0,0 +1,246 @@
+/* Copyright (C) 2016 Murray Cumming
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef MURRAYCDP_LINEAR_RECURRENCE_H
+#define MURRAYCDP_LINEAR_RECURRENCE_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace murraycdp {
+namespace utils {
+
+/**
+ * A linear recurrence, in which each term is a weighted sum of the previous k
+ * terms:
+ *   x(n) = c1 * x(n - 1) + c2 * x(n - 2) + ... + ck * x(n - k)
+ * such as the fibonacci numbers, with c1 = c2 = 1.
+ *
+ * A DpBottomUpBase, such as the DpFibonacci example, calculates all n terms.
+ * Instead, this uses Kitamasa's method: It finds x^n modulo the recurrence's
+ * characteristic polynomial, by repeated squaring, whose k coefficients then
+ * give x(n) as a weighted sum of the first k terms. That takes
+ * O(k^2 * log(n)) time, so n can be huge.
+ *
+ * Terms of huge n are usually only useful modulo some number, often a prime,
+ * so you may give a modulus. Then all arithmetic is modulo that, and the
+ * coefficients and initial values may be negative.
+ *
+ * @tparam T_value An integer type, such as unsigned long long.
+ */
+template <typename T_value>
+class linear_recurrence {
+public:
+  static_assert(std::is_integral<T_value>::value,
+    "linear_recurrence needs an integer type.");
+
+  using value_type = T_value;
+  using size_type = std::size_t;
+  using type_vec_values = std::vector<T_value>;
+
+  /**
+   * @param coefficients c1 to ck.
+   * @param initial_values x(0) to x(k - 1).
+   * @param modulus The modulus for all arithmetic, or 0 for none, in which
+   * case the terms must not overflow T_value. It must not be negative.
+   */
+  linear_recurrence(const type_vec_values& coefficients,
+    const type_vec_values& initial_values, T_value modulus = 0)
+  : modulus_(modulus) {
+    assert(!coefficients.empty());
+    assert(coefficients.size() == initial_values.size());
+
+    for (const auto value : coefficients) {
+      coefficients_.emplace_back(normalize(value));
+    }
+
+    for (const auto value : initial_values) {
+      initial_values_.emplace_back(normalize(value));
+    }
+  }
+
+  /** Get x(n).
+   */
+  T_value
+  calc(unsigned long long n) const {
+    const auto k = coefficients_.size();
+    if (n < k) {
+      return initial_values_[n];
+    }
+
+    // x^n modulo the characteristic polynomial,
+    // by squaring x^1 and multiplying it into x^0:
+    type_vec_values result(k, 0);
+    type_vec_values square(k, 0);
+    if (k == 1) {
+      result[0] = 1;
+      square[0] = coefficients_[0];
+    } else {
+      result[0] = 1;
+      square[1] = 1;
+    }
+
+    // Reuse one buffer for the products, instead of allocating one for each:
+    type_vec_values product(2 * k - 1, 0);
+    while (n > 0) {
+      if (n & 1) {
+        multiply_polynomials(result, square, product);
+      }
+
+      n >>= 1;
+      if (n > 0) {
+        multiply_polynomials(square, square, product);
+      }
+    }
+
+    T_value term = 0;
+    for (size_type i = 0; i < k; ++i) {
+      term = add(term, multiply(result[i], initial_values_[i]));
+    }
+
+    return term;
+  }
+
+  /** The count of previous terms that each term depends on.
+   */
+  size_type
+  size() const {
+    return coefficients_.size();
+  }
+
+  T_value
+  get_modulus() const {
+    return modulus_;
+  }
+
+private:
+  /** Multiply two polynomials of degree less than k, modulo the
+   * characteristic polynomial, x^k - c1 * x^(k-1) - ... - ck,
+   * putting the result in @a a.
+   *
+   * @param product A buffer of size 2k - 1.
+   */
+  void
+  multiply_polynomials(
+    type_vec_values& a, const type_vec_values& b, type_vec_values& product) const {
+    const auto k = coefficients_.size();
+    std::fill(std::begin(product), std::end(product), 0);
+    for (size_type i = 0; i < k; ++i) {
+      if (a[i] == 0) {
+        continue;
+      }
+
+      for (size_type j = 0; j < k; ++j) {
+        product[i + j] = add(product[i + j], multiply(a[i], b[j]));
+      }
+    }
+
+    // Replace each x^d, from the highest, with
+    // c1 * x^(d-1) + c2 * x^(d-2) + ... + ck * x^(d-k):
+    for (size_type d = 2 * k - 2; d >= k; --d) {
+      const auto high = product[d];
+      if (high == 0) {
+        continue;
+      }
+
+      for (size_type j = 0; j < k; ++j) {
+        product[d - 1 - j] =
+          add(product[d - 1 - j], multiply(high, coefficients_[j]));
+      }
+    }
+
+    std::copy(std::begin(product), std::begin(product) + k, std::begin(a));
+  }
+
+  T_value
+  normalize(T_value value) const {
+    if (modulus_ == 0) {
+      return value;
+    }
+
+    value %= modulus_;
+
+    // Avoid a warning about this always being false for unsigned types:
+    const bool negative = value < static_cast<T_value>(0);
+    return negative ? value + modulus_ : value;
+  }
+
+  T_value
+  add(T_value a, T_value b) const {
+    if (modulus_ == 0) {
+      return a + b;
+    }
+
+    // a + b might overflow, for a large modulus:
+    return (a >= modulus_ - b) ? a - (modulus_ - b) : a + b;
+  }
+
+  T_value
+  multiply(T_value a, T_value b) const {
+    if (modulus_ == 0) {
+      return a * b;
+    }
+
+    return multiply_modulo(a, b);
+  }
+
+  /** a * b % modulus_, for a and b in [0, modulus_), without overflow.
+   */
+  T_value
+  multiply_modulo(T_value a, T_value b) const {
+    // The product fits in 64 bits, whose division is much quicker:
+    if (static_cast<unsigned long long>(modulus_) <= (1ull << 32)) {
+      return static_cast<T_value>(static_cast<unsigned long long>(a) *
+                                  static_cast<unsigned long long>(b) %
+                                  static_cast<unsigned long long>(modulus_));
+    }
+
+#if defined(__GNUC__)
+    if (sizeof(T_value) <= sizeof(unsigned long long)) {
+      // __extension__ avoids a -pedantic warning about __int128:
+      __extension__ using type_wide = unsigned __int128;
+      return static_cast<T_value>(
+        static_cast<type_wide>(a) * static_cast<type_wide>(b) %
+        static_cast<type_wide>(modulus_));
+    }
+#endif
+
+    // Double and add:
+    T_value result = 0;
+    while (b > 0) {
+      if (b & 1) {
+        result = add(result, a);
+      }
+
+      a = add(a, a);
+      b >>= 1;
+    }
+
+    return result;
+  }
+
+  const T_value modulus_;
+  type_vec_values coefficients_;
+  type_vec_values initial_values_;
+};
+
+} // namespace utils
+} // namespace murraycdp
+
+#endif // MURRAYCDP_LINEAR_RECURRENCE_H
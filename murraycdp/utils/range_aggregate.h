@@ -0,0 +1,172 @@
+/* Copyright (C) 2016 Murray Cumming
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef MURRAYCDP_RANGE_AGGREGATE_H
+#define MURRAYCDP_RANGE_AGGREGATE_H
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <vector>
+
+namespace murraycdp {
+namespace utils {
+
+/**
+ * Answers sum, min and max queries over ranges of a fixed sequence of values,
+ * each in O(1) time, after O(n log n) preparation.
+ *
+ * Dynamic programming cost functions often need the sum (or min, or max) of
+ * the items in the range that a sub-problem covers. Calculating that with
+ * std::accumulate() adds a hidden O(n) factor to every sub-problem.
+ * Instead, create one of these once, before filling the table, and use it in
+ * calc_subproblem().
+ *
+ * The sums use a prefix-sum array. The mins and maxes use sparse tables.
+ *
+ * For instance:
+ * @code
+ *   const range_aggregate<unsigned int> freqs(std::begin(items),
+ *     std::end(items), [](const auto& item) { return item.percentage; });
+ *   const auto freq_sum = freqs.sum(i, i + s);
+ * @endcode
+ *
+ * All ranges are half-open: [first, last).
+ *
+ * @tparam T_value The type of the values, such as unsigned int.
+ */
+template <typename T_value>
+class range_aggregate {
+public:
+  using value_type = T_value;
+  using size_type = typename std::vector<T_value>::size_type;
+
+  range_aggregate() = default;
+
+  explicit range_aggregate(const std::vector<T_value>& values)
+  : range_aggregate(std::begin(values), std::end(values),
+      [](const T_value& value) { return value; }) {}
+
+  /**
+   * @param first The start of the sequence.
+   * @param last One past the end of the sequence.
+   * @param get_value Gets the value to aggregate from each item in the
+   * sequence.
+   */
+  template <typename T_iter, typename T_function>
+  range_aggregate(T_iter first, T_iter last, T_function get_value) {
+    std::vector<T_value> values;
+    values.reserve(std::distance(first, last));
+    for (auto iter = first; iter != last; ++iter) {
+      values.emplace_back(get_value(*iter));
+    }
+
+    build(values);
+  }
+
+  size_type
+  size() const {
+    return prefix_sums_.empty() ? 0 : prefix_sums_.size() - 1;
+  }
+
+  /** The sum of the values in [first, last), or T_value() if the range is
+   * empty.
+   */
+  T_value
+  sum(size_type first, size_type last) const {
+    assert(first <= last);
+    assert(last <= size());
+    return prefix_sums_[last] - prefix_sums_[first];
+  }
+
+  /** The smallest value in [first, last), which must not be empty.
+   */
+  T_value
+  min(size_type first, size_type last) const {
+    const auto k = level_for_range(first, last);
+    return std::min(mins_[k][first], mins_[k][last - (size_type(1) << k)]);
+  }
+
+  /** The largest value in [first, last), which must not be empty.
+   */
+  T_value
+  max(size_type first, size_type last) const {
+    const auto k = level_for_range(first, last);
+    return std::max(maxes_[k][first], maxes_[k][last - (size_type(1) << k)]);
+  }
+
+private:
+  using type_table = std::vector<std::vector<T_value>>;
+
+  void
+  build(const std::vector<T_value>& values) {
+    const auto n = values.size();
+
+    prefix_sums_.assign(n + 1, T_value());
+    for (size_type i = 0; i < n; ++i) {
+      prefix_sums_[i + 1] = prefix_sums_[i] + values[i];
+    }
+
+    // log2s_[len] is floor(log2(len)), so that any range can be covered by
+    // two (possibly overlapping) ranges whose length is a power of 2.
+    log2s_.assign(n + 1, 0);
+    for (size_type len = 2; len <= n; ++len) {
+      log2s_[len] = log2s_[len / 2] + 1;
+    }
+
+    // mins_[k][i] is the min of the 2^k values starting at i:
+    const size_type levels = n == 0 ? 0 : log2s_[n] + 1;
+    mins_.assign(levels, std::vector<T_value>());
+    maxes_.assign(levels, std::vector<T_value>());
+    if (levels == 0) {
+      return;
+    }
+
+    mins_[0] = values;
+    maxes_[0] = values;
+    for (size_type k = 1; k < levels; ++k) {
+      const size_type half = size_type(1) << (k - 1);
+      const size_type count = n - (size_type(1) << k) + 1;
+      auto& mins_k = mins_[k];
+      auto& maxes_k = maxes_[k];
+      const auto& mins_prev = mins_[k - 1];
+      const auto& maxes_prev = maxes_[k - 1];
+      mins_k.resize(count);
+      maxes_k.resize(count);
+      for (size_type i = 0; i < count; ++i) {
+        mins_k[i] = std::min(mins_prev[i], mins_prev[i + half]);
+        maxes_k[i] = std::max(maxes_prev[i], maxes_prev[i + half]);
+      }
+    }
+  }
+
+  size_type
+  level_for_range(size_type first, size_type last) const {
+    assert(first < last);
+    assert(last <= size());
+    return log2s_[last - first];
+  }
+
+  std::vector<T_value> prefix_sums_;
+  std::vector<size_type> log2s_;
+  type_table mins_;
+  type_table maxes_;
+};
+
+} // namespace utils
+} // namespace murraycdp
+
+#endif // MURRAYCDP_RANGE_AGGREGATE_H
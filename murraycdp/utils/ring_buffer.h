@@ -0,0 +1,177 @@
+/* Copyright (C) 2016 Murray Cumming
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef MURRAYCDP_RING_BUFFER_H
+#define MURRAYCDP_RING_BUFFER_H
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+
+namespace murraycdp {
+namespace utils {
+
+/**
+ * The last T_CAPACITY items of a sequence, such as the rows of a bottom-up
+ * dynamic programming table, with get(0) being the newest item, get(-1) the
+ * one before, and so on.
+ *
+ * Unlike circular_vector, the capacity is known at compile time, and the
+ * items are in a std::array whose size is T_CAPACITY rounded up to a power
+ * of 2. So finding an item's position is just an addition and a mask, with no
+ * branches, and step() just increments a count.
+ *
+ * The items never move, so references and pointers to them stay valid after
+ * step(). For instance, a reference to get(0) then refers to get(-1), until
+ * the item is reused T_CAPACITY steps later.
+ *
+ * In debug builds, get() and get_at_offset_from_start() assert that the item
+ * is one of the last T_CAPACITY items.
+ *
+ * @tparam T_CAPACITY The count of items to keep, including get(0).
+ */
+template <typename T, std::size_t T_CAPACITY>
+class ring_buffer {
+public:
+  static_assert(T_CAPACITY > 0, "ring_buffer needs a capacity of at least 1.");
+
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  /**
+   * Create a ring buffer with each item having value @a value.
+   */
+  explicit ring_buffer(const T& value = T()) {
+    items_.fill(value);
+  }
+
+  ring_buffer(const ring_buffer& src) = default;
+  ring_buffer&
+  operator=(const ring_buffer& src) = default;
+
+  ring_buffer(ring_buffer&& src) noexcept = default;
+  ring_buffer&
+  operator=(ring_buffer&& src) noexcept = default;
+
+  /** Get the item @a offset steps ago, with an @a offset of 0 or less.
+   */
+  T&
+  get(difference_type offset) {
+    return items_[pos_for_offset(offset)];
+  }
+
+  const T&
+  get(difference_type offset) const {
+    return items_[pos_for_offset(offset)];
+  }
+
+  /** For instance, get the 5th item,
+   * regardless of how many times we have called step(),
+   * as long as it is one of the last T_CAPACITY items.
+   */
+  T&
+  get_at_offset_from_start(size_type index) {
+    return items_[pos_for_index(index)];
+  }
+
+  const T&
+  get_at_offset_from_start(size_type index) const {
+    return items_[pos_for_index(index)];
+  }
+
+  /** Cause get(-1) to return whatever get(0) currently returns.
+   */
+  void
+  step() {
+    ++steps_count_;
+  }
+
+  /** Returns which index get(0) now represents.
+   */
+  size_type
+  steps_count() const {
+    return steps_count_;
+  }
+
+  static constexpr size_type
+  size() {
+    return T_CAPACITY;
+  }
+
+  template <class T_UnaryFunction>
+  void foreach (T_UnaryFunction f) {
+    for (auto& item : items_) {
+      f(item);
+    }
+  }
+
+  /** Set every item to @a value, and make get(0) the first item again.
+   */
+  void
+  clear(const T& value = T()) {
+    steps_count_ = 0;
+    items_.fill(value);
+  }
+
+private:
+  static constexpr size_type
+  round_up_to_power_of_2(size_type n) {
+    size_type result = 1;
+    while (result < n) {
+      result <<= 1;
+    }
+
+    return result;
+  }
+
+  static constexpr size_type COUNT_SLOTS = round_up_to_power_of_2(T_CAPACITY);
+  static constexpr size_type MASK = COUNT_SLOTS - 1;
+
+  size_type
+  pos_for_offset(difference_type offset) const {
+    assert(offset <= 0);
+    assert(static_cast<size_type>(-offset) < T_CAPACITY);
+
+    // Unsigned arithmetic wraps around modulo a power of 2, which COUNT_SLOTS
+    // divides, so this is correct even before there have been enough steps:
+    return (steps_count_ + static_cast<size_type>(offset)) & MASK;
+  }
+
+  size_type
+  pos_for_index(size_type index) const {
+    assert(index <= steps_count_);
+    assert(steps_count_ - index < T_CAPACITY);
+
+    return index & MASK;
+  }
+
+  size_type steps_count_ = 0;
+  std::array<T, COUNT_SLOTS> items_;
+};
+
+template <typename T, std::size_t T_CAPACITY>
+constexpr typename ring_buffer<T, T_CAPACITY>::size_type
+  ring_buffer<T, T_CAPACITY>::COUNT_SLOTS;
+
+template <typename T, std::size_t T_CAPACITY>
+constexpr typename ring_buffer<T, T_CAPACITY>::size_type
+  ring_buffer<T, T_CAPACITY>::MASK;
+
+} // namespace utils
+} // namespace murraycdp
+
+#endif // MURRAYCDP_RING_BUFFER_H
@@ -0,0 +1,322 @@
+/* Copyright (C) 2016 Murray Cumming
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef MURRAYCDP_SEMIRING_MATRIX_H
+#define MURRAYCDP_SEMIRING_MATRIX_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace murraycdp {
+namespace utils {
+
+/**
+ * The (max, +) semiring, in which "adding" takes the maximum and
+ * "multiplying" adds. Its zero, which no path can beat, is -infinity.
+ *
+ * For types without an infinity, zero() is a quarter of lowest(), so that
+ * adding two values cannot overflow. Then a value is treated as zero if it is
+ * no more than half of zero(), so the real values must stay well within that.
+ *
+ * @tparam T_value A signed type, such as long long or double.
+ */
+template <typename T_value>
+class max_plus {
+public:
+  static_assert(std::numeric_limits<T_value>::is_signed,
+    "max_plus needs a signed type for its -infinity.");
+
+  using value_type = T_value;
+
+  static constexpr T_value
+  zero() {
+    return std::numeric_limits<T_value>::has_infinity
+             ? -std::numeric_limits<T_value>::infinity()
+             : std::numeric_limits<T_value>::lowest() / 4;
+  }
+
+  static constexpr T_value
+  one() {
+    return T_value();
+  }
+
+  static constexpr bool
+  is_zero(T_value value) {
+    return value <= zero() / 2;
+  }
+
+  static constexpr T_value
+  add(T_value a, T_value b) {
+    return a < b ? b : a;
+  }
+
+  static constexpr T_value
+  multiply(T_value a, T_value b) {
+    return a + b;
+  }
+};
+
+/**
+ * The (min, +) semiring, in which "adding" takes the minimum and
+ * "multiplying" adds. Its zero, which every path beats, is +infinity.
+ *
+ * For types without an infinity, zero() is a quarter of max(), as for
+ * max_plus.
+ *
+ * @tparam T_value The type of the values, such as long long or double.
+ */
+template <typename T_value>
+class min_plus {
+public:
+  using value_type = T_value;
+
+  static constexpr T_value
+  zero() {
+    return std::numeric_limits<T_value>::has_infinity
+             ? std::numeric_limits<T_value>::infinity()
+             : std::numeric_limits<T_value>::max() / 4;
+  }
+
+  static constexpr T_value
+  one() {
+    return T_value();
+  }
+
+  static constexpr bool
+  is_zero(T_value value) {
+    return value >= zero() / 2;
+  }
+
+  static constexpr T_value
+  add(T_value a, T_value b) {
+    return b < a ? b : a;
+  }
+
+  static constexpr T_value
+  multiply(T_value a, T_value b) {
+    return a + b;
+  }
+};
+
+/**
+ * A square matrix over a semiring such as max_plus or min_plus, whose
+ * powers give the terms of recurrences far into a sequence without
+ * calculating the terms in between.
+ *
+ * @tparam T_semiring A class with value_type, and static zero(), one(),
+ * is_zero(), add() and multiply() methods, such as max_plus<long long>.
+ */
+template <typename T_semiring>
+class semiring_matrix {
+public:
+  using semiring = T_semiring;
+  using value_type = typename T_semiring::value_type;
+  using size_type = std::size_t;
+
+  /**
+   * Create a @a size by @a size matrix of the semiring's zero.
+   */
+  explicit semiring_matrix(size_type size)
+  : size_(size), values_(size * size, T_semiring::zero()) {}
+
+  semiring_matrix(const semiring_matrix& src) = default;
+  semiring_matrix&
+  operator=(const semiring_matrix& src) = default;
+
+  semiring_matrix(semiring_matrix&& src) noexcept = default;
+  semiring_matrix&
+  operator=(semiring_matrix&& src) noexcept = default;
+
+  /** A matrix with the semiring's one on the diagonal.
+   */
+  static semiring_matrix
+  identity(size_type size) {
+    semiring_matrix result(size);
+    for (size_type i = 0; i < size; ++i) {
+      result(i, i) = T_semiring::one();
+    }
+
+    return result;
+  }
+
+  size_type
+  size() const {
+    return size_;
+  }
+
+  value_type&
+  operator()(size_type row, size_type column) {
+    assert(row < size_);
+    assert(column < size_);
+    return values_[row * size_ + column];
+  }
+
+  const value_type&
+  operator()(size_type row, size_type column) const {
+    assert(row < size_);
+    assert(column < size_);
+    return values_[row * size_ + column];
+  }
+
+  semiring_matrix
+  operator*(const semiring_matrix& b) const {
+    assert(size_ == b.size_);
+
+    // Going along a row of b, and of the result, in the inner loop, with no
+    // branches, lets the compiler vectorize it.
+    semiring_matrix result(size_);
+    for (size_type i = 0; i < size_; ++i) {
+      value_type* out = &result.values_[i * size_];
+      for (size_type k = 0; k < size_; ++k) {
+        const auto a = values_[i * size_ + k];
+        if (T_semiring::is_zero(a)) {
+          continue;
+        }
+
+        const value_type* b_row = &b.values_[k * size_];
+        for (size_type j = 0; j < size_; ++j) {
+          out[j] = T_semiring::add(out[j], T_semiring::multiply(a, b_row[j]));
+        }
+      }
+    }
+
+    return result;
+  }
+
+  /** Raise this matrix to the power @a exponent, by repeated squaring, with
+   * O(log(exponent)) multiplications.
+   */
+  semiring_matrix
+  power(unsigned long long exponent) const {
+    auto result = identity(size_);
+    auto square = *this;
+    while (exponent > 0) {
+      if (exponent & 1) {
+        result = result * square;
+      }
+
+      exponent >>= 1;
+      if (exponent > 0) {
+        square = square * square;
+      }
+    }
+
+    return result;
+  }
+
+  /** Multiply this matrix by the column vector @a vec.
+   */
+  std::vector<value_type>
+  multiply(const std::vector<value_type>& vec) const {
+    assert(vec.size() == size_);
+
+    std::vector<value_type> result(size_, T_semiring::zero());
+    for (size_type i = 0; i < size_; ++i) {
+      for (size_type j = 0; j < size_; ++j) {
+        result[i] = T_semiring::add(
+          result[i], T_semiring::multiply(values_[i * size_ + j], vec[j]));
+      }
+    }
+
+    return result;
+  }
+
+private:
+  size_type size_;
+  std::vector<value_type> values_;
+};
+
+/**
+ * A recurrence in which each term depends on only the previous k terms:
+ *   x(n) = (c1 * x(n - 1)) + (c2 * x(n - 2)) + ... + (ck * x(n - k))
+ * using the semiring's add() and multiply().
+ *
+ * For instance, with max_plus, the best price for a rod of length n, for a
+ * price list whose longest piece is k, is
+ *   x(n) = max over j of (price(j) + x(n - j)).
+ * A DpBottomUpBase, such as DpRodCutting, calculates all n terms, in
+ * O(n * k) time. Instead, this raises the k by k companion matrix to the
+ * power n, in O(k^3 * log(n)) time, so n can be huge.
+ *
+ * @tparam T_semiring A semiring such as max_plus<long long>.
+ */
+template <typename T_semiring>
+class lookback_recurrence {
+public:
+  using value_type = typename T_semiring::value_type;
+  using size_type = std::size_t;
+  using type_vec_values = std::vector<value_type>;
+
+  /**
+   * @param coefficients c1 to ck. Use the semiring's zero() for terms that
+   * are not used.
+   * @param initial_values The first terms, x(0), x(1), and so on, which are
+   * not calculated from the recurrence. There must be at least one.
+   * Any earlier terms that the recurrence uses are the semiring's zero().
+   */
+  lookback_recurrence(
+    const type_vec_values& coefficients, const type_vec_values& initial_values)
+  : initial_values_(initial_values), companion_(coefficients.size()) {
+    assert(!coefficients.empty());
+    assert(!initial_values.empty());
+
+    // Row 0 calculates the next term.
+    // The other rows move the previous terms along:
+    const auto k = coefficients.size();
+    for (size_type j = 0; j < k; ++j) {
+      companion_(0, j) = coefficients[j];
+    }
+
+    for (size_type i = 1; i < k; ++i) {
+      companion_(i, i - 1) = T_semiring::one();
+    }
+
+    // The last k of the initial terms, most recent first:
+    const auto m = initial_values.size();
+    last_initial_values_.assign(k, T_semiring::zero());
+    for (size_type j = 0; j < k && j < m; ++j) {
+      last_initial_values_[j] = initial_values[m - 1 - j];
+    }
+  }
+
+  /** Get x(n).
+   */
+  value_type
+  calc(unsigned long long n) const {
+    const auto m = initial_values_.size();
+    if (n < m) {
+      return initial_values_[n];
+    }
+
+    const auto terms =
+      companion_.power(n - (m - 1)).multiply(last_initial_values_);
+    return terms[0];
+  }
+
+private:
+  const type_vec_values initial_values_;
+  type_vec_values last_initial_values_;
+  semiring_matrix<T_semiring> companion_;
+};
+
+} // namespace utils
+} // namespace murraycdp
+
+#endif // MURRAYCDP_SEMIRING_MATRIX_H
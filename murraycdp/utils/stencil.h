@@ -0,0 +1,153 @@
+/* Copyright (C) 2016 Murray Cumming
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef MURRAYCDP_STENCIL_H
+#define MURRAYCDP_STENCIL_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+
+namespace murraycdp {
+namespace utils {
+
+/**
+ * One of the sub-problems that each sub-problem depends on, as offsets from
+ * its i, j, and so on. For instance, offset<-1, 0> is the sub-problem at
+ * (i - 1, j).
+ *
+ * The sub-problem must be calculated before the sub-problem that depends on
+ * it, when a bottom-up algorithm goes through i, then j, and so on, in
+ * increasing order. So the first offset that is not 0 must be negative.
+ */
+template <std::ptrdiff_t... T_offsets>
+class offset {
+public:
+  static constexpr std::size_t COUNT_DIMENSIONS = sizeof...(T_offsets);
+  using type_offsets = std::array<std::ptrdiff_t, COUNT_DIMENSIONS>;
+
+  static_assert(COUNT_DIMENSIONS > 0, "offset needs at least 1 dimension.");
+
+  static constexpr bool
+  is_earlier(std::initializer_list<std::ptrdiff_t> offsets) {
+    for (const auto value : offsets) {
+      if (value != 0) {
+        return value < 0;
+      }
+    }
+
+    return false;
+  }
+
+  static_assert(is_earlier({T_offsets...}),
+    "An offset must be to a sub-problem that is calculated earlier.");
+
+  /** The offset of i, which is never positive.
+   */
+  static constexpr std::ptrdiff_t
+  get_i_offset() {
+    return *std::begin({T_offsets...});
+  }
+
+  static constexpr type_offsets
+  get_offsets() {
+    return type_offsets{{T_offsets...}};
+  }
+
+  static bool
+  equals(const type_offsets& offsets) {
+    return offsets == get_offsets();
+  }
+};
+
+template <std::ptrdiff_t... T_offsets>
+constexpr std::size_t offset<T_offsets...>::COUNT_DIMENSIONS;
+
+/**
+ * The sub-problems that each sub-problem depends on, such as
+ *   stencil<offset<-1, -1>, offset<-1, 0>, offset<0, -1>>
+ * for LCS or string edit distance, or
+ *   stencil<offset<-1>, offset<-2>>
+ * for fibonacci.
+ *
+ * See DpBottomUpStencilBase, which uses this to decide how many values of i
+ * to keep sub-problems for.
+ *
+ * @tparam T_offsets offset<> types, all with the same count of dimensions.
+ */
+template <typename T_first_offset, typename... T_offsets>
+class stencil {
+public:
+  static constexpr std::size_t COUNT_DIMENSIONS =
+    T_first_offset::COUNT_DIMENSIONS;
+  static constexpr std::size_t COUNT_OFFSETS = 1 + sizeof...(T_offsets);
+  using type_offsets = std::array<std::ptrdiff_t, COUNT_DIMENSIONS>;
+
+  static constexpr bool
+  all_true(std::initializer_list<bool> values) {
+    for (const auto value : values) {
+      if (!value) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  static_assert(all_true({(T_offsets::COUNT_DIMENSIONS == COUNT_DIMENSIONS)...}),
+    "All offsets in a stencil need the same count of dimensions.");
+
+  /** The most values of i, before the current one, that a sub-problem
+   * depends on.
+   */
+  static constexpr std::size_t
+  get_count_i_back() {
+    return static_cast<std::size_t>(-std::min({T_first_offset::get_i_offset(),
+      T_offsets::get_i_offset()...}));
+  }
+
+  /** All of the stencil's offsets, in the order of its offset<> types.
+   * For instance, DpBestFirstStencilBase follows each of these backwards, to
+   * find the sub-problems that depend on a sub-problem.
+   */
+  static constexpr std::array<type_offsets, COUNT_OFFSETS>
+  get_offsets() {
+    return std::array<type_offsets, COUNT_OFFSETS>{
+      {T_first_offset::get_offsets(), T_offsets::get_offsets()...}};
+  }
+
+  /** Whether the sub-problem at these offsets is one of the stencil's.
+   */
+  static bool
+  contains(const type_offsets& offsets) {
+    const bool results[] = {T_first_offset::equals(offsets),
+      T_offsets::equals(offsets)...};
+    return std::any_of(std::begin(results), std::end(results),
+      [](bool result) { return result; });
+  }
+};
+
+template <typename T_first_offset, typename... T_offsets>
+constexpr std::size_t stencil<T_first_offset, T_offsets...>::COUNT_DIMENSIONS;
+
+template <typename T_first_offset, typename... T_offsets>
+constexpr std::size_t stencil<T_first_offset, T_offsets...>::COUNT_OFFSETS;
+
+} // namespace utils
+} // namespace murraycdp
+
+#endif // MURRAYCDP_STENCIL_H
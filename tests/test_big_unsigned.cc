@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <vector>
+#include <murraycdp/utils/big_unsigned.h>
+
+using murraycdp::utils::big_unsigned;
+
+static big_unsigned
+get_power(const big_unsigned& base, unsigned int exponent) {
+  big_unsigned result = 1;
+  for (unsigned int i = 0; i < exponent; ++i) {
+    result *= base;
+  }
+
+  return result;
+}
+
+static big_unsigned
+get_random(std::size_t bits_count, std::mt19937& generator) {
+  std::uniform_int_distribution<unsigned int> bit_distribution(0, 1);
+  big_unsigned result;
+  for (std::size_t i = 0; i < bits_count; ++i) {
+    result += result;
+    if (bit_distribution(generator)) {
+      result += 1;
+    }
+  }
+
+  return result;
+}
+
+/** A random number with more bits than get_random() can quickly make,
+ * as a random high part, shifted, plus a random low part.
+ */
+static big_unsigned
+get_big_random(std::size_t bits_count, std::mt19937& generator) {
+  if (bits_count <= 20000) {
+    return get_random(bits_count, generator);
+  }
+
+  const auto low_bits_count = bits_count / 2;
+  big_unsigned shift = 1;
+  big_unsigned power = 2;
+  for (auto exponent = low_bits_count; exponent > 0; exponent >>= 1) {
+    if (exponent & 1) {
+      shift *= power;
+    }
+
+    power *= power;
+  }
+
+  return get_big_random(bits_count - low_bits_count, generator) * shift +
+         get_big_random(low_bits_count, generator);
+}
+
+void
+test_small() {
+  const big_unsigned zero;
+  assert(zero.is_zero());
+  assert(zero == 0);
+  assert(zero.to_string() == "0");
+  assert(zero.bit_count() == 0);
+
+  const big_unsigned a = 1234567890123456789ull;
+  assert(a.to_string() == "1234567890123456789");
+  assert(a.get_low_bits() == 1234567890123456789ull);
+  assert(a.remainder(1000) == 789);
+  assert(a > zero);
+  assert(zero < a);
+  assert(a - a == zero);
+  assert(a + zero == a);
+  assert(a * zero == zero);
+
+  std::ostringstream stream;
+  stream << big_unsigned(42);
+  assert(stream.str() == "42");
+}
+
+void
+test_carries() {
+  const big_unsigned max = 18446744073709551615ull; // 2^64 - 1
+  const auto two_64 = max + 1;
+  assert(two_64.to_string() == "18446744073709551616");
+  assert(two_64.bit_count() == 65);
+  assert(two_64.get_low_bits() == 0);
+  assert(two_64 - 1 == max);
+  assert((two_64 * two_64).to_string() ==
+         "340282366920938463463374607431768211456");
+  assert((max * max).to_string() == "340282366920938463426481119284349108225");
+}
+
+void
+test_powers() {
+  assert(get_power(3, 200).to_string() ==
+         "265613988875874769338781322035779626829233452653394495974574961739"
+         "092490901302182994384699044001");
+}
+
+void
+test_karatsuba() {
+  // Check products big enough to use Karatsuba's algorithm, of equal and
+  // different sizes, and squares, against their remainders, and by
+  // distributing them:
+  std::mt19937 generator(1);
+  std::uniform_int_distribution<std::size_t> bits_distribution(1, 20000);
+  for (auto attempt = 0; attempt < 50; ++attempt) {
+    const auto a = get_random(bits_distribution(generator), generator);
+    const auto b = get_random(bits_distribution(generator), generator);
+    const auto c = get_random(bits_distribution(generator), generator);
+    const auto product = a * b;
+    assert(product == b * a);
+    assert(a * (b + c) == product + a * c);
+    assert((a + b) * (a + b) == a * a + b * b + product + product);
+
+    for (const std::uint32_t divisor : {1000000007u, 4294967291u}) {
+      const auto expected = static_cast<unsigned long long>(
+                              a.remainder(divisor)) *
+                            b.remainder(divisor) % divisor;
+      assert(product.remainder(divisor) == expected);
+    }
+
+    assert(product.bit_count() + 1 >= a.bit_count() + b.bit_count());
+    assert(product.bit_count() <= a.bit_count() + b.bit_count());
+  }
+}
+
+void
+test_toom3() {
+  // Check products big enough to use Toom-3, with Karatsuba's algorithm for
+  // its smaller products, of equal and different sizes, and squares:
+  std::mt19937 generator(1);
+  std::uniform_int_distribution<std::size_t> bits_distribution(10000, 200000);
+  for (auto attempt = 0; attempt < 10; ++attempt) {
+    const auto a = get_big_random(bits_distribution(generator), generator);
+    const auto b = get_big_random(bits_distribution(generator), generator);
+    const auto c = get_big_random(bits_distribution(generator), generator);
+    const auto product = a * b;
+    assert(product == b * a);
+    assert(a * (b + c) == product + a * c);
+    assert((a + b) * (a + b) == a * a + b * b + product + product);
+
+    for (const std::uint32_t divisor : {1000000007u, 4294967291u}) {
+      const auto expected = static_cast<unsigned long long>(
+                              a.remainder(divisor)) *
+                            b.remainder(divisor) % divisor;
+      assert(product.remainder(divisor) == expected);
+      assert((a * a).remainder(divisor) ==
+             static_cast<unsigned long long>(a.remainder(divisor)) *
+               a.remainder(divisor) % divisor);
+    }
+
+    assert(product.bit_count() + 1 >= a.bit_count() + b.bit_count());
+    assert(product.bit_count() <= a.bit_count() + b.bit_count());
+  }
+}
+
+void
+test_subproblem() {
+  // As a T_subproblem, it should work like the built-in types:
+  std::vector<big_unsigned> fibonacci = {0, 1};
+  for (std::size_t i = 2; i <= 500; ++i) {
+    fibonacci.emplace_back(fibonacci[i - 1] + fibonacci[i - 2]);
+  }
+
+  assert(fibonacci[500].to_string() ==
+         "139423224561697880139724382870407283950070256587697307264108962948325"
+         "571622863290691557658876222521294125");
+  assert(std::is_sorted(fibonacci.begin(), fibonacci.end()));
+}
+
+int
+main() {
+  test_small();
+  test_carries();
+  test_powers();
+  test_karatsuba();
+  test_toom3();
+  test_subproblem();
+
+  return EXIT_SUCCESS;
+}
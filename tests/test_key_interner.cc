@@ -0,0 +1,126 @@
+#include <cassert>
+#include <cstdlib>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <murraycdp/utils/key_interner.h>
+
+namespace std {
+
+template <>
+struct hash<std::vector<std::size_t>> {
+  size_t
+  operator()(const std::vector<std::size_t>& value) const {
+    size_t result = 0;
+    for (const auto item : value) {
+      result = result * 31 + item;
+    }
+
+    return result;
+  }
+};
+
+} // namespace std
+
+void
+test_scalars() {
+  using type_interner = murraycdp::utils::key_interner<unsigned int, char>;
+  static_assert(std::is_same<type_interner::type_key,
+                  std::tuple<unsigned int, char>>::value,
+    "Scalars should not be interned.");
+
+  type_interner interner;
+  type_interner::type_key key;
+  assert(interner.find(key, 3, 'a'));
+  assert(key == std::make_tuple(3u, 'a'));
+  assert(interner.intern(3, 'a') == key);
+  assert(interner.size() == 0);
+}
+
+void
+test_strings() {
+  using type_interner =
+    murraycdp::utils::key_interner<unsigned int, std::string>;
+  static_assert(std::is_same<type_interner::type_key,
+                  std::tuple<unsigned int, std::size_t>>::value,
+    "Strings should be interned.");
+
+  type_interner interner;
+  type_interner::type_key key;
+  assert(!interner.find(key, 1, "noun"));
+
+  // Finding doesn't intern:
+  assert(interner.size() == 0);
+
+  const auto noun = interner.intern(1, "noun");
+  const auto verb = interner.intern(1, "verb");
+  assert(noun != verb);
+  assert(interner.size() == 2);
+
+  assert(interner.find(key, 1, "noun"));
+  assert(key == noun);
+  assert(interner.intern(1, "noun") == noun);
+
+  // The same string, with a different scalar:
+  const auto noun2 = interner.intern(2, "noun");
+  assert(std::get<1>(noun2) == std::get<1>(noun));
+  assert(std::get<0>(noun2) == 2);
+  assert(interner.size() == 2);
+
+  interner.clear();
+  assert(interner.size() == 0);
+  assert(!interner.find(key, 1, "noun"));
+}
+
+void
+test_vectors() {
+  using type_ids = std::vector<std::size_t>;
+  using type_interner =
+    murraycdp::utils::key_interner<std::size_t, type_ids, std::size_t>;
+
+  type_interner interner;
+  const auto a = interner.intern(4, type_ids{0, 2, 3}, 2);
+  const auto b = interner.intern(4, type_ids{0, 2}, 2);
+  assert(a != b);
+  assert(interner.size() == 2);
+
+  type_interner::type_key key;
+  assert(interner.find(key, 4, type_ids{0, 2, 3}, 2));
+  assert(key == a);
+  assert(!interner.find(key, 4, type_ids{0, 3}, 2));
+}
+
+void
+test_call_with_values() {
+  using type_interner =
+    murraycdp::utils::key_interner<unsigned int, std::string>;
+
+  type_interner interner;
+  auto key = interner.intern(1, "noun");
+  interner.intern(1, "verb");
+
+  // Scalars are their own ids, so they can be changed without interning:
+  std::get<0>(key) = 5;
+  const auto values = interner.call_with_values(
+    key, [](unsigned int i, const std::string& name) {
+      return std::make_pair(i, name);
+    });
+  assert(values.first == 5);
+  assert(values.second == "noun");
+
+  type_interner::type_key found;
+  assert(interner.find(found, 5, "noun"));
+  assert(found == key);
+}
+
+int
+main() {
+  test_scalars();
+  test_strings();
+  test_vectors();
+  test_call_with_values();
+
+  return EXIT_SUCCESS;
+}
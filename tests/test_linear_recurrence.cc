@@ -0,0 +1,110 @@
+#include <cassert>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include <murraycdp/utils/linear_recurrence.h>
+
+/** Calculate the terms one at a time, modulo @a modulus, if it is not 0.
+ */
+static std::vector<long long>
+calc_terms_simply(const std::vector<long long>& coefficients,
+  const std::vector<long long>& initial_values, long long modulus,
+  std::size_t count) {
+  auto result = initial_values;
+  if (modulus != 0) {
+    for (auto& value : result) {
+      value = ((value % modulus) + modulus) % modulus;
+    }
+  }
+
+  for (auto n = result.size(); n < count; ++n) {
+    long long term = 0;
+    for (std::size_t j = 1; j <= coefficients.size(); ++j) {
+      term += coefficients[j - 1] * result[n - j];
+      if (modulus != 0) {
+        term %= modulus;
+      }
+    }
+
+    if (modulus != 0 && term < 0) {
+      term += modulus;
+    }
+
+    result.emplace_back(term);
+  }
+
+  return result;
+}
+
+void
+test_fibonacci() {
+  const murraycdp::utils::linear_recurrence<unsigned long long> fibonacci(
+    {1, 1}, {0, 1});
+  assert(fibonacci.calc(0) == 0);
+  assert(fibonacci.calc(1) == 1);
+  assert(fibonacci.calc(10) == 55);
+  assert(fibonacci.calc(90) == 2880067194370816120ull);
+
+  const murraycdp::utils::linear_recurrence<unsigned long long>
+    fibonacci_modulo({1, 1}, {0, 1}, 1000000007);
+  assert(fibonacci_modulo.calc(90) == 2880067194370816120ull % 1000000007);
+  assert(fibonacci_modulo.calc(1000000000000000000ull) == 209783453);
+}
+
+void
+test_one_term() {
+  // Powers of 3:
+  const murraycdp::utils::linear_recurrence<unsigned long long> powers(
+    {3}, {1});
+  assert(powers.calc(0) == 1);
+  assert(powers.calc(1) == 3);
+  assert(powers.calc(40) == 12157665459056928801ull);
+}
+
+void
+test_large_modulus() {
+  // A prime near 2^61, so products need more than 64 bits:
+  const unsigned long long modulus = 2305843009213693951ull;
+  const murraycdp::utils::linear_recurrence<unsigned long long> powers(
+    {modulus - 1}, {1}, modulus);
+
+  // (-1)^n:
+  assert(powers.calc(1000000000000000000ull) == 1);
+  assert(powers.calc(1000000000000000001ull) == modulus - 1);
+}
+
+void
+test_random() {
+  std::mt19937 generator(1);
+  std::uniform_int_distribution<std::size_t> size_distribution(1, 6);
+  std::uniform_int_distribution<long long> value_distribution(-50, 50);
+  for (auto attempt = 0; attempt < 100; ++attempt) {
+    const auto k = size_distribution(generator);
+    std::vector<long long> coefficients(k);
+    std::vector<long long> initial_values(k);
+    for (std::size_t i = 0; i < k; ++i) {
+      coefficients[i] = value_distribution(generator);
+      initial_values[i] = value_distribution(generator);
+    }
+
+    for (const long long modulus : {7ll, 998244353ll}) {
+      const murraycdp::utils::linear_recurrence<long long> recurrence(
+        coefficients, initial_values, modulus);
+      const auto expected =
+        calc_terms_simply(coefficients, initial_values, modulus, 200);
+      for (std::size_t n = 0; n < expected.size(); ++n) {
+        assert(recurrence.calc(n) == expected[n]);
+      }
+    }
+  }
+}
+
+int
+main() {
+  test_fibonacci();
+  test_one_term();
+  test_large_modulus();
+  test_random();
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,60 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <numeric>
+#include <vector>
+#include <murraycdp/utils/range_aggregate.h>
+
+void
+test_empty() {
+  const murraycdp::utils::range_aggregate<int> ranges;
+  assert(ranges.size() == 0);
+
+  const murraycdp::utils::range_aggregate<int> ranges_empty(std::vector<int>{});
+  assert(ranges_empty.size() == 0);
+  assert(ranges_empty.sum(0, 0) == 0);
+}
+
+void
+test_against_brute_force() {
+  const std::vector<int> values = {5, -3, 8, 8, 0, 12, -7, 4, 4, 1, 9, 2, -1};
+  const murraycdp::utils::range_aggregate<int> ranges(values);
+  assert(ranges.size() == values.size());
+
+  const auto b = std::begin(values);
+  for (std::size_t first = 0; first < values.size(); ++first) {
+    assert(ranges.sum(first, first) == 0);
+
+    for (std::size_t last = first + 1; last <= values.size(); ++last) {
+      assert(ranges.sum(first, last) == std::accumulate(b + first, b + last, 0));
+      assert(ranges.min(first, last) == *std::min_element(b + first, b + last));
+      assert(ranges.max(first, last) == *std::max_element(b + first, b + last));
+    }
+  }
+}
+
+class Item {
+public:
+  char item;
+  unsigned int percentage;
+};
+
+void
+test_get_value() {
+  const std::vector<Item> items = {{'a', 11}, {'b', 10}, {'c', 12}, {'d', 22}};
+  const murraycdp::utils::range_aggregate<unsigned int> ranges(std::begin(items),
+    std::end(items), [](const Item& item) { return item.percentage; });
+  assert(ranges.sum(0, 4) == 55);
+  assert(ranges.sum(1, 3) == 22);
+  assert(ranges.min(0, 4) == 10);
+  assert(ranges.max(0, 3) == 12);
+}
+
+int
+main() {
+  test_empty();
+  test_against_brute_force();
+  test_get_value();
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,151 @@
+#include <boost/timer/timer.hpp>
+#include <cassert>
+#include <climits>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <murraycdp/utils/circular_vector.h>
+#include <murraycdp/utils/ring_buffer.h>
+
+void
+test_get() {
+  murraycdp::utils::ring_buffer<int, 3> buffer;
+  assert(buffer.size() == 3);
+  assert(buffer.get(0) == 0);
+
+  for (auto i = 0; i < 10; ++i) {
+    if (i != 0) {
+      buffer.step();
+    }
+
+    buffer.get(0) = i;
+    assert(buffer.steps_count() == static_cast<std::size_t>(i));
+    assert(buffer.get_at_offset_from_start(i) == i);
+
+    for (auto offset = 0; offset < 3 && offset <= i; ++offset) {
+      assert(buffer.get(-offset) == i - offset);
+      assert(buffer.get_at_offset_from_start(i - offset) == i - offset);
+    }
+  }
+}
+
+void
+test_stable_references() {
+  murraycdp::utils::ring_buffer<std::vector<int>, 2> buffer(
+    std::vector<int>(5, 1));
+
+  auto& row = buffer.get(0);
+  const auto data = row.data();
+  row[2] = 7;
+
+  buffer.step();
+  assert(&buffer.get(-1) == &row);
+  assert(buffer.get(-1).data() == data);
+  assert(buffer.get(-1)[2] == 7);
+  assert(buffer.get(0)[2] == 1);
+}
+
+void
+test_clear() {
+  murraycdp::utils::ring_buffer<int, 2> buffer(5);
+  buffer.get(0) = 1;
+  buffer.step();
+  buffer.get(0) = 2;
+
+  buffer.clear(3);
+  assert(buffer.steps_count() == 0);
+  assert(buffer.get(0) == 3);
+  assert(buffer.get(-1) == 3);
+}
+
+void
+test_circular_vector() {
+  murraycdp::utils::circular_vector<int> vec(3);
+  for (auto i = 0; i < 3; ++i) {
+    vec.get(i) = i;
+  }
+
+  // Positive offsets past the end wrap around to the start:
+  vec.step();
+  vec.step();
+  assert(vec.get(0) == 2);
+  assert(vec.get(1) == 0);
+  assert(vec.get(2) == 1);
+  assert(vec.get(-1) == 1);
+
+  vec.clear(4);
+  for (auto i = 0; i < 3; ++i) {
+    assert(vec.get(i) == 4);
+  }
+}
+
+/** Step a circular_vector past INT_MAX, as DpBottomUpBase does for a table
+ * with that many rows, so its step count and indices must not wrap around.
+ */
+void
+test_circular_vector_big_index() {
+  murraycdp::utils::circular_vector<std::size_t> vec(3);
+  const std::size_t count = static_cast<std::size_t>(INT_MAX) + 10;
+  for (std::size_t i = 1; i <= count; ++i) {
+    vec.step();
+
+    // Only the last few items are checked:
+    if (i + vec.size() > count) {
+      vec.get(0) = i;
+    }
+  }
+
+  assert(vec.steps_count() == count);
+  assert(vec.get(0) == count);
+  assert(vec.get(-2) == count - 2);
+  assert(vec.get_at_offset_from_start(count) == count);
+  assert(vec.get_at_offset_from_start(count - 1) == count - 1);
+}
+
+/** Compare a ring_buffer with a circular_vector, for a recurrence that
+ * reads the previous 3 items for each step:
+ *   x(i) = x(i - 1) + x(i - 2) + x(i - 3)
+ */
+void
+benchmark() {
+  const std::size_t count = 10000000;
+
+  std::cout << "circular_vector:" << std::endl;
+  unsigned int expected = 0;
+  {
+    boost::timer::auto_cpu_timer timer;
+    murraycdp::utils::circular_vector<unsigned int> vec(4);
+    vec.get(0) = 1;
+    for (std::size_t i = 1; i < count; ++i) {
+      vec.step();
+      vec.get(0) = vec.get(-1) + vec.get(-2) + vec.get(-3);
+    }
+
+    expected = vec.get(0);
+  }
+
+  std::cout << "ring_buffer:" << std::endl;
+  {
+    boost::timer::auto_cpu_timer timer;
+    murraycdp::utils::ring_buffer<unsigned int, 4> buffer;
+    buffer.get(0) = 1;
+    for (std::size_t i = 1; i < count; ++i) {
+      buffer.step();
+      buffer.get(0) = buffer.get(-1) + buffer.get(-2) + buffer.get(-3);
+    }
+
+    assert(buffer.get(0) == expected);
+  }
+}
+
+int
+main() {
+  test_get();
+  test_stable_references();
+  test_clear();
+  test_circular_vector();
+  test_circular_vector_big_index();
+  benchmark();
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include <murraycdp/utils/semiring_matrix.h>
+
+template <typename T_semiring>
+static std::vector<typename T_semiring::value_type>
+calc_terms_simply(const std::vector<typename T_semiring::value_type>& coefficients,
+  const std::vector<typename T_semiring::value_type>& initial_values,
+  std::size_t count) {
+  auto result = initial_values;
+  for (auto n = result.size(); n < count; ++n) {
+    auto term = T_semiring::zero();
+    for (std::size_t j = 1; j <= coefficients.size() && j <= n; ++j) {
+      term = T_semiring::add(
+        term, T_semiring::multiply(coefficients[j - 1], result[n - j]));
+    }
+
+    result.emplace_back(term);
+  }
+
+  return result;
+}
+
+template <typename T_semiring>
+static void
+check_against_simple_terms(
+  const std::vector<typename T_semiring::value_type>& coefficients,
+  const std::vector<typename T_semiring::value_type>& initial_values) {
+  const murraycdp::utils::lookback_recurrence<T_semiring> recurrence(
+    coefficients, initial_values);
+  const auto expected =
+    calc_terms_simply<T_semiring>(coefficients, initial_values, 100);
+  for (std::size_t n = 0; n < expected.size(); ++n) {
+    const auto term = recurrence.calc(n);
+    if (T_semiring::is_zero(expected[n])) {
+      assert(T_semiring::is_zero(term));
+    } else {
+      assert(term == expected[n]);
+    }
+  }
+}
+
+void
+test_identity() {
+  using type_matrix =
+    murraycdp::utils::semiring_matrix<murraycdp::utils::max_plus<int>>;
+  type_matrix a(3);
+  int value = -4;
+  for (std::size_t i = 0; i < 3; ++i) {
+    for (std::size_t j = 0; j < 3; ++j) {
+      a(i, j) = value++;
+    }
+  }
+
+  const auto identity = type_matrix::identity(3);
+  for (const auto& product : {a * identity, identity * a, a.power(1)}) {
+    for (std::size_t i = 0; i < 3; ++i) {
+      for (std::size_t j = 0; j < 3; ++j) {
+        assert(product(i, j) == a(i, j));
+      }
+    }
+  }
+}
+
+void
+test_max_plus_rod_cutting() {
+  // As in the dp_bottom_up_rod_cutting example, whose answers for lengths 4,
+  // 5 and 9 are 10, 13 and 25:
+  const std::vector<long long> prices = {1, 5, 8, 9, 10, 17, 17, 20, 24, 30};
+  const murraycdp::utils::lookback_recurrence<
+    murraycdp::utils::max_plus<long long>>
+    recurrence(prices, {0});
+  assert(recurrence.calc(0) == 0);
+  assert(recurrence.calc(4) == 10);
+  assert(recurrence.calc(5) == 13);
+  assert(recurrence.calc(9) == 25);
+
+  check_against_simple_terms<murraycdp::utils::max_plus<long long>>(
+    prices, {0});
+}
+
+void
+test_min_plus_steps() {
+  // The cheapest way to climb n steps, taking 1, 2, or 3 at a time,
+  // when 3 at a time costs less per step:
+  using type_semiring = murraycdp::utils::min_plus<long long>;
+  const std::vector<long long> costs = {3, 5, 6};
+  const murraycdp::utils::lookback_recurrence<type_semiring> recurrence(
+    costs, {0});
+  assert(recurrence.calc(3) == 6);
+  assert(recurrence.calc(4) == 9);
+  assert(recurrence.calc(3000000000000) == 6000000000000);
+  check_against_simple_terms<type_semiring>(costs, {0});
+
+  // Only even counts of steps are possible:
+  const auto zero = type_semiring::zero();
+  const murraycdp::utils::lookback_recurrence<type_semiring> even(
+    {zero, 1}, {0});
+  assert(even.calc(1000000000000) == 500000000000);
+  assert(type_semiring::is_zero(even.calc(1000000000001)));
+  check_against_simple_terms<type_semiring>({zero, 1}, {0});
+}
+
+void
+test_double() {
+  using type_semiring = murraycdp::utils::max_plus<double>;
+  const murraycdp::utils::lookback_recurrence<type_semiring> recurrence(
+    {type_semiring::zero(), 1.5, 2.0}, {0, type_semiring::zero()});
+  assert(type_semiring::is_zero(recurrence.calc(1)));
+  assert(recurrence.calc(2) == 1.5);
+  assert(recurrence.calc(5) == 3.5);
+}
+
+template <typename T_semiring>
+static void
+test_random() {
+  std::mt19937 generator(1);
+  std::uniform_int_distribution<std::size_t> size_distribution(1, 8);
+  std::uniform_int_distribution<int> value_distribution(-20, 20);
+  for (auto attempt = 0; attempt < 100; ++attempt) {
+    std::vector<long long> coefficients(size_distribution(generator));
+    for (auto& coefficient : coefficients) {
+      // Leave some terms unused:
+      const auto value = value_distribution(generator);
+      coefficient = (value < -10) ? T_semiring::zero() : value;
+    }
+
+    std::vector<long long> initial_values(size_distribution(generator));
+    for (auto& value : initial_values) {
+      value = value_distribution(generator);
+    }
+
+    check_against_simple_terms<T_semiring>(coefficients, initial_values);
+  }
+}
+
+int
+main() {
+  test_identity();
+  test_max_plus_rod_cutting();
+  test_min_plus_steps();
+  test_double();
+  test_random<murraycdp::utils::max_plus<long long>>();
+  test_random<murraycdp::utils::min_plus<long long>>();
+
+  return EXIT_SUCCESS;
+}
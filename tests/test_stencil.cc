@@ -0,0 +1,77 @@
+#include <cassert>
+#include <cstdlib>
+#include <murraycdp/dp_bottom_up_stencil_base.h>
+#include <murraycdp/utils/stencil.h>
+
+using murraycdp::utils::offset;
+using murraycdp::utils::stencil;
+
+void
+test_count_i_back() {
+  using type_lcs = stencil<offset<-1, -1>, offset<-1, 0>, offset<0, -1>>;
+  static_assert(type_lcs::COUNT_DIMENSIONS == 2, "unexpected dimensions");
+  static_assert(type_lcs::get_count_i_back() == 1, "unexpected count");
+
+  using type_row = stencil<offset<0, -1>, offset<0, -2>>;
+  static_assert(type_row::get_count_i_back() == 0, "unexpected count");
+
+  using type_triple_step = stencil<offset<-1>, offset<-2>, offset<-3>>;
+  static_assert(type_triple_step::get_count_i_back() == 3, "unexpected count");
+}
+
+void
+test_count_to_keep() {
+  // The 2D DpBottomUpBase also keeps the current i:
+  static_assert(murraycdp::get_count_subproblems_to_keep_for_stencil<
+                  stencil<offset<-1, -1>, offset<-1, 0>, offset<0, -1>>>() ==
+                  2,
+    "unexpected count");
+  static_assert(murraycdp::get_count_subproblems_to_keep_for_stencil<
+                  stencil<offset<0, -1>>>() == 1,
+    "unexpected count");
+  static_assert(murraycdp::get_count_subproblems_to_keep_for_stencil<
+                  stencil<offset<-2, 3, 0>>>() == 3,
+    "unexpected count");
+
+  // But the 1D DpBottomUpBase only keeps the previous values of i:
+  static_assert(murraycdp::get_count_subproblems_to_keep_for_stencil<
+                  stencil<offset<-1>, offset<-2>>>() == 2,
+    "unexpected count");
+}
+
+void
+test_contains() {
+  using type_stencil = stencil<offset<-1, -1>, offset<-1, 0>, offset<0, -1>>;
+  assert(type_stencil::contains({{-1, -1}}));
+  assert(type_stencil::contains({{-1, 0}}));
+  assert(type_stencil::contains({{0, -1}}));
+  assert(!type_stencil::contains({{0, 0}}));
+  assert(!type_stencil::contains({{-2, 0}}));
+  assert(!type_stencil::contains({{-1, 1}}));
+}
+
+void
+test_get_offsets() {
+  using type_stencil = stencil<offset<-1, -1>, offset<-1, 0>, offset<0, -1>>;
+  static_assert(type_stencil::COUNT_OFFSETS == 3, "unexpected count");
+
+  const auto offsets = type_stencil::get_offsets();
+  assert(offsets.size() == 3);
+  assert((offsets[0] == type_stencil::type_offsets{{-1, -1}}));
+  assert((offsets[1] == type_stencil::type_offsets{{-1, 0}}));
+  assert((offsets[2] == type_stencil::type_offsets{{0, -1}}));
+
+  for (const auto& offsets_item : offsets) {
+    assert(type_stencil::contains(offsets_item));
+  }
+}
+
+int
+main() {
+  test_count_i_back();
+  test_count_to_keep();
+  test_contains();
+  test_get_offsets();
+
+  return EXIT_SUCCESS;
+}